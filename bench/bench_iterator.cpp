@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+
+#include "types/directionaliterator.h"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace Types;
+
+TEST_CASE("Directional iterator traversal", "[iterator]")
+{
+    std::vector<int> v(100000);
+    std::iota(v.begin(), v.end(), 0);
+
+    BENCHMARK("DirectionalIterator forward")
+    {
+        long sum = 0;
+        for(DirectionalIterator<int> i(v.data(), true), e(v.data() + v.size(), true); i != e; i++) sum += *i;
+        return sum;
+    };
+
+    BENCHMARK("DirectionalIterator backward")
+    {
+        long sum = 0;
+        for(DirectionalIterator<int> i(v.data() + v.size() - 1, false), e(v.data() - 1, false); i != e; i++) sum += *i;
+        return sum;
+    };
+
+    BENCHMARK("Pointer forward")
+    {
+        long sum = 0;
+        for(int *i = v.data(), *e = v.data() + v.size(); i != e; i++) sum += *i;
+        return sum;
+    };
+
+    BENCHMARK("std::vector reverse_iterator")
+    {
+        long sum = 0;
+        for(auto i = v.rbegin(); i != v.rend(); i++) sum += *i;
+        return sum;
+    };
+}
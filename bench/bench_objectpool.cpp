@@ -0,0 +1,77 @@
+#include <catch2/catch.hpp>
+
+#include "types/objectpool.h"
+#include "types/stack.h"
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Types;
+
+static const int ROUNDS = 20000;
+static const int THREADS = 4;
+
+namespace
+{
+    struct Buffer { char data[256]; };
+
+    /**
+     * @brief LockedFreeList The mutex protected Stack<T*> free list ObjectPool replaces
+     */
+    struct LockedFreeList
+    {
+        std::mutex lock;
+        Stack<Buffer*> objects;
+
+        ~LockedFreeList() { for(Buffer *b : objects) delete b; }
+
+        Buffer *acquire()
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            return objects.size() ? objects.pull_top() : new Buffer();
+        }
+
+        void release(Buffer *b)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            objects.push_top(b);
+        }
+    };
+
+    template <typename Pool>
+    void churn(Pool &pool)
+    {
+        std::vector<std::thread> threads;
+        for(int t = 0; t < THREADS; t++)
+        {
+            threads.emplace_back([&pool] {
+                Buffer *held[4];
+                for(int i = 0; i < ROUNDS; i++)
+                {
+                    for(Buffer *&b : held) b = pool.acquire();
+                    for(Buffer *b : held) pool.release(b);
+                }
+            });
+        }
+        for(std::thread &t : threads)
+            t.join();
+    }
+}
+
+TEST_CASE("ObjectPool contention", "[objectpool]")
+{
+    BENCHMARK("Stack<T*> free list behind a mutex")
+    {
+        LockedFreeList list;
+        churn(list);
+        return list.objects.size();
+    };
+
+    BENCHMARK("ObjectPool")
+    {
+        ObjectPool<Buffer> pool;
+        churn(pool);
+        return pool.created();
+    };
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include "types/parallel.h"
+#include "types/stack.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Types;
+
+static const int ELEMENTS = 1 << 22;
+static const int SORT_ELEMENTS = 1 << 20;
+
+namespace
+{
+    /**
+     * @brief threadCounts 1, 2, 4, ... up to the number of hardware threads
+     */
+    std::vector<std::size_t> threadCounts()
+    {
+        std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+
+        std::vector<std::size_t> counts;
+        for(std::size_t n = 1; n < hardware; n *= 2)
+            counts.push_back(n);
+        counts.push_back(hardware);
+        return counts;
+    }
+
+    Stack<double> makeStack(int n)
+    {
+        Stack<double> stack(n);
+        for(int i = 0; i < n; i++)
+            stack.push_top(double((i * 2654435761u) % 1000003));
+        return stack;
+    }
+}
+
+TEST_CASE("Stack parallel scaling", "[stack][parallel]")
+{
+    Stack<double> stack = makeStack(ELEMENTS);
+
+    BENCHMARK("serial loop over begin()/end() reduce")
+    {
+        return std::accumulate(stack.begin(), stack.end(), 0.0);
+    };
+
+    for(std::size_t threads : threadCounts())
+    {
+        Parallel::ThreadPool pool(threads);
+        Parallel::Policy policy{ &pool };
+        std::string suffix = " with " + std::to_string(threads) + " threads";
+
+        BENCHMARK("parallel_for_each" + suffix)
+        {
+            Parallel::for_each(stack, [](double &v) { v = std::sqrt(v * v + 1.0); }, policy);
+            return stack.size();
+        };
+
+        BENCHMARK("parallel_transform" + suffix)
+        {
+            return Parallel::transform(stack, [](const double &v) { return std::sqrt(v) * 0.5; }, policy).size();
+        };
+
+        BENCHMARK("parallel_reduce" + suffix)
+        {
+            return Parallel::reduce(stack, 0.0, std::plus<double>(), policy);
+        };
+    }
+}
+
+TEST_CASE("Stack parallel sort scaling", "[stack][parallel]")
+{
+    Stack<double> source = makeStack(SORT_ELEMENTS);
+
+    BENCHMARK_ADVANCED("std::sort over begin()/end()")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<Stack<double>> copies(meter.runs(), source);
+        meter.measure([&](int i) { std::sort(copies[i].begin(), copies[i].end()); });
+    };
+
+    for(std::size_t threads : threadCounts())
+    {
+        Parallel::ThreadPool pool(threads);
+        Parallel::Policy policy{ &pool };
+
+        BENCHMARK_ADVANCED("parallel_sort with " + std::to_string(threads) + " threads")(Catch::Benchmark::Chronometer meter)
+        {
+            std::vector<Stack<double>> copies(meter.runs(), source);
+            meter.measure([&](int i) { Parallel::sort(copies[i], std::less<double>(), policy); });
+        };
+    }
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch.hpp>
+
+#include "types/prioritystack.h"
+
+#include <queue>
+#include <vector>
+
+using namespace Types;
+
+static const int N = 10000;
+
+static int key(int i) { return int((i * 2654435761u) % 100003); }
+
+TEST_CASE("PriorityStack push and pull", "[prioritystack]")
+{
+    BENCHMARK("PriorityStack<int> push/pull_top")
+    {
+        PriorityStack<int> heap(N);
+        for(int i = 0; i < N; i++) heap.push(key(i));
+        long sum = 0;
+        while(!heap.empty()) sum += heap.pull_top();
+        return sum;
+    };
+
+    BENCHMARK("PriorityStack<int, less, 2> push/pull_top")
+    {
+        PriorityStack<int, std::less<int>, 2> heap(N);
+        for(int i = 0; i < N; i++) heap.push(key(i));
+        long sum = 0;
+        while(!heap.empty()) sum += heap.pull_top();
+        return sum;
+    };
+
+    BENCHMARK("std::priority_queue push/pop")
+    {
+        std::vector<int> storage;
+        storage.reserve(N);
+        std::priority_queue<int> queue(std::less<int>(), std::move(storage));
+        for(int i = 0; i < N; i++) queue.push(key(i));
+        long sum = 0;
+        while(!queue.empty()) { sum += queue.top(); queue.pop(); }
+        return sum;
+    };
+}
+
+TEST_CASE("PriorityStack heapify", "[prioritystack]")
+{
+    BENCHMARK("PriorityStack heapify")
+    {
+        Stack<int> stack(N);
+        for(int i = 0; i < N; i++) stack.push_top(key(i));
+        PriorityStack<int> heap(std::move(stack));
+        return heap.top();
+    };
+
+    BENCHMARK("std::priority_queue from range")
+    {
+        std::vector<int> v;
+        v.reserve(N);
+        for(int i = 0; i < N; i++) v.push_back(key(i));
+        std::priority_queue<int> queue(std::less<int>(), std::move(v));
+        return queue.top();
+    };
+}
@@ -0,0 +1,196 @@
+#include <catch2/catch.hpp>
+
+#include "types/soastack.h"
+#include "types/stack.h"
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <vector>
+
+using namespace Types;
+
+static const int N = 10000;
+
+TEST_CASE("Stack push and pull at the top", "[stack]")
+{
+    BENCHMARK("Stack push_top/pull_top")
+    {
+        Stack<int> s(N);
+        for(int i = 0; i < N; i++) s.push_top(i);
+        long sum = 0;
+        for(int i = 0; i < N; i++) sum += s.pull_top();
+        return sum;
+    };
+
+    BENCHMARK("std::vector push_back/pop_back")
+    {
+        std::vector<int> v;
+        v.reserve(N);
+        for(int i = 0; i < N; i++) v.push_back(i);
+        long sum = 0;
+        for(int i = 0; i < N; i++) { sum += v.back(); v.pop_back(); }
+        return sum;
+    };
+
+    BENCHMARK("std::deque push_back/pop_back")
+    {
+        std::deque<int> d;
+        for(int i = 0; i < N; i++) d.push_back(i);
+        long sum = 0;
+        for(int i = 0; i < N; i++) { sum += d.back(); d.pop_back(); }
+        return sum;
+    };
+}
+
+TEST_CASE("Stack push and pull at the bottom", "[stack]")
+{
+    BENCHMARK("Stack push_bottom/pull_bottom")
+    {
+        Stack<int> s(N, N);
+        for(int i = 0; i < N; i++) s.push_bottom(i);
+        long sum = 0;
+        for(int i = 0; i < N; i++) sum += s.pull_bottom();
+        return sum;
+    };
+
+    BENCHMARK("std::deque push_front/pop_front")
+    {
+        std::deque<int> d;
+        for(int i = 0; i < N; i++) d.push_front(i);
+        long sum = 0;
+        for(int i = 0; i < N; i++) { sum += d.front(); d.pop_front(); }
+        return sum;
+    };
+}
+
+TEST_CASE("Stack growth", "[stack]")
+{
+    BENCHMARK("Stack push_top from capacity 1")
+    {
+        Stack<int> s(1);
+        for(int i = 0; i < N; i++) s.push_top(i);
+        return s.size();
+    };
+
+    BENCHMARK("Stack push_bottom from capacity 1")
+    {
+        Stack<int> s(1);
+        for(int i = 0; i < N; i++) s.push_bottom(i);
+        return s.size();
+    };
+
+    BENCHMARK("std::vector push_back without reserve")
+    {
+        std::vector<int> v;
+        for(int i = 0; i < N; i++) v.push_back(i);
+        return v.size();
+    };
+}
+
+TEST_CASE("Stack concatenation", "[stack]")
+{
+    Stack<int> a(N), b(N);
+    std::vector<int> va, vb;
+    for(int i = 0; i < N; i++) { a.push_top(i); b.push_top(-i); va.push_back(i); vb.push_back(-i); }
+
+    BENCHMARK("Stack operator+=")
+    {
+        Stack<int> c = a;
+        c += b;
+        return c.size();
+    };
+
+    BENCHMARK("std::vector insert")
+    {
+        std::vector<int> c = va;
+        c.insert(c.end(), vb.begin(), vb.end());
+        return c.size();
+    };
+}
+
+TEST_CASE("Stack iteration", "[stack]")
+{
+    Stack<int> s(N);
+    std::vector<int> v;
+    std::deque<int> d;
+    for(int i = 0; i < N; i++) { s.push_top(i); v.push_back(i); d.push_back(i); }
+
+    BENCHMARK("Stack DirectionalIterator")
+    {
+        long sum = 0;
+        for(int i : s) sum += i;
+        return sum;
+    };
+
+    BENCHMARK("Stack drain_top coroutine")
+    {
+        Stack<int> c = s;
+        long sum = 0;
+        for(int i : c.drain_top()) sum += i;
+        return sum;
+    };
+
+    BENCHMARK("Stack pull_top loop")
+    {
+        Stack<int> c = s;
+        long sum = 0;
+        while(c.size()) sum += c.pull_top();
+        return sum;
+    };
+
+    BENCHMARK("std::vector iterator")
+    {
+        long sum = 0;
+        for(int i : v) sum += i;
+        return sum;
+    };
+
+    BENCHMARK("std::deque iterator")
+    {
+        long sum = 0;
+        for(int i : d) sum += i;
+        return sum;
+    };
+}
+
+TEST_CASE("Stack bulk operations", "[stack]")
+{
+    Stack<int> a(N), b(N);
+    std::vector<int> v;
+    for(int i = 0; i < N; i++) { a.push_top(i % 97); b.push_top(i % 97); v.push_back(i % 97); }
+
+    BENCHMARK("Stack sum")       { return a.sum(); };
+    BENCHMARK("std::accumulate") { return std::accumulate(v.begin(), v.end(), 0); };
+
+    BENCHMARK("Stack count")     { return a.count(42); };
+    BENCHMARK("std::count")      { return std::count(v.begin(), v.end(), 42); };
+
+    BENCHMARK("Stack find miss") { return a.find(-1) == a.end(); };
+    BENCHMARK("std::find miss")  { return std::find(v.begin(), v.end(), -1) == v.end(); };
+
+    BENCHMARK("Stack ==")        { return a == b; };
+    BENCHMARK("Stack max")       { return a.max(); };
+}
+
+TEST_CASE("Stack of records and SoAStack", "[stack]")
+{
+    struct Particle { float x, y, z, vx, vy, vz; int kind; };
+
+    Stack<Particle> aos(N);
+    SoAStack<float, float, float, float, float, float, int> soa(N);
+    for(int i = 0; i < N; i++)
+    {
+        aos.push_top(Particle{ float(i), 0, 0, 1, 1, 1, i % 4 });
+        soa.push_top(float(i), 0, 0, 1, 1, 1, i % 4);
+    }
+
+    BENCHMARK("Stack<Particle> sum of x")
+    {
+        float sum = 0;
+        for(const Particle &p : aos) sum += p.x;
+        return sum;
+    };
+
+    BENCHMARK("SoAStack column sum of x") { return soa.column<0>().sum(); };
+}
@@ -0,0 +1,259 @@
+#include <catch2/catch.hpp>
+
+#include "types/tree.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Types;
+
+namespace
+{
+    /**
+     * @brief BaselineNode Plain pointer based tree the Tree benchmarks are compared against
+     */
+    struct BaselineNode
+    {
+        int contents;
+        std::vector<std::unique_ptr<BaselineNode>> children;
+        std::map<std::string, BaselineNode*> labeled;
+
+        BaselineNode(int contents) : contents(contents) { }
+
+        BaselineNode(const BaselineNode &other) : contents(other.contents)
+        {
+            for(auto &c : other.children)
+                children.push_back(std::make_unique<BaselineNode>(*c));
+        }
+
+        bool operator==(const BaselineNode &other) const
+        {
+            if(contents != other.contents || children.size() != other.children.size())
+                return false;
+            for(std::size_t i = 0; i < children.size(); i++)
+                if(!(*children[i] == *other.children[i]))
+                    return false;
+            return true;
+        }
+    };
+
+    const int FANOUT = 16;
+
+    std::vector<std::string> makeLabels()
+    {
+        std::vector<std::string> labels;
+        for(int i = 0; i < FANOUT; i++)
+            labels.push_back("label" + std::to_string(i));
+        return labels;
+    }
+
+    const std::vector<std::string> labels = makeLabels();
+
+    template <typename Node = Tree<int>>
+    Node *buildTree()
+    {
+        Node *root = new Node(0);
+        for(int i = 0; i < FANOUT; i++)
+        {
+            root->setChild(i, labels[i]);
+            Node *c = (*root)[labels[i]];
+            for(int j = 0; j < FANOUT; j++)
+            {
+                c->setChild(j, labels[j]);
+                Node *g = (*c)[labels[j]];
+                for(int k = 0; k < FANOUT; k++)
+                    g->addChild(k);
+            }
+        }
+        return root;
+    }
+
+    BaselineNode *buildBaseline()
+    {
+        BaselineNode *root = new BaselineNode(0);
+        for(int i = 0; i < FANOUT; i++)
+        {
+            root->children.push_back(std::make_unique<BaselineNode>(i));
+            BaselineNode *c = root->labeled[labels[i]] = root->children.back().get();
+            for(int j = 0; j < FANOUT; j++)
+            {
+                c->children.push_back(std::make_unique<BaselineNode>(j));
+                BaselineNode *g = c->labeled[labels[j]] = c->children.back().get();
+                for(int k = 0; k < FANOUT; k++)
+                    g->children.push_back(std::make_unique<BaselineNode>(k));
+            }
+        }
+        return root;
+    }
+}
+
+TEST_CASE("Tree build and destruction", "[tree]")
+{
+    BENCHMARK("Tree build and destroy")
+    {
+        Tree<int> *t = buildTree();
+        delete t;
+        return t != nullptr;
+    };
+
+    BENCHMARK("Baseline build and destroy")
+    {
+        BaselineNode *t = buildBaseline();
+        delete t;
+        return t != nullptr;
+    };
+
+    BENCHMARK_ADVANCED("Tree destroy")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<Tree<int>*> trees(meter.runs());
+        for(auto &t : trees) t = buildTree();
+        meter.measure([&](int i) { delete trees[i]; });
+    };
+
+    BENCHMARK_ADVANCED("Baseline destroy")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<BaselineNode*> trees(meter.runs());
+        for(auto &t : trees) t = buildBaseline();
+        meter.measure([&](int i) { delete trees[i]; });
+    };
+}
+
+TEST_CASE("Tree label lookup", "[tree]")
+{
+    std::unique_ptr<Tree<int>> t(buildTree());
+    std::unique_ptr<BaselineNode> b(buildBaseline());
+
+    BENCHMARK("Tree operator[]")
+    {
+        long sum = 0;
+        for(auto &l1 : labels)
+            for(auto &l2 : labels)
+                sum += **(*(*t)[l1])[l2];
+        return sum;
+    };
+
+    BENCHMARK("Baseline std::map lookup")
+    {
+        long sum = 0;
+        for(auto &l1 : labels)
+            for(auto &l2 : labels)
+                sum += b->labeled.find(l1)->second->labeled.find(l2)->second->contents;
+        return sum;
+    };
+}
+
+TEST_CASE("Tree copy and comparison", "[tree]")
+{
+    std::unique_ptr<Tree<int>> t(buildTree());
+    std::unique_ptr<BaselineNode> b(buildBaseline());
+
+    BENCHMARK("Tree deep copy")
+    {
+        Tree<int> c = *t;
+        return *c;
+    };
+
+    BENCHMARK("Baseline deep copy")
+    {
+        BaselineNode c = *b;
+        return c.contents;
+    };
+
+    Tree<int> tc = *t;
+    BaselineNode bc = *b;
+
+    BENCHMARK("Tree equality")
+    {
+        return tc == *t;
+    };
+
+    BENCHMARK("Baseline equality")
+    {
+        return bc == *b;
+    };
+}
+
+TEST_CASE("Tree traversal", "[tree]")
+{
+    std::unique_ptr<Tree<int>> t(buildTree());
+
+    BENCHMARK("Tree walkPreorder coroutine")
+    {
+        long sum = 0;
+        for(Tree<int> &n : t->walkPreorder()) sum += *n;
+        return sum;
+    };
+
+    BENCHMARK("Tree TreeIterator loops")
+    {
+        long sum = **t;
+        for(Tree<int> &c : *t)
+        {
+            sum += *c;
+            for(Tree<int> &g : c)
+            {
+                sum += *g;
+                for(Tree<int> &l : g)
+                    sum += *l;
+            }
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("Tree subtree aggregates", "[tree]")
+{
+    using Node = Tree<int, std::string, Aggregates<SubtreeSize, SubtreeSum<long>, SubtreeHeight>>;
+    std::unique_ptr<Node> t(buildTree<Node>());
+    Node *inner = (*(*t)[labels[3]])[labels[5]];
+
+    BENCHMARK("Tree walkPreorder for size, sum and height")
+    {
+        long size = 0, sum = 0;
+        std::size_t height = 0;
+        for(Node &n : t->walkPreorder())
+        {
+            size++;
+            sum += *n;
+            std::size_t depth = 1;
+            for(Node *p = &n; p != t.get(); p = p->getParent())
+                depth++;
+            height = std::max(height, depth);
+        }
+        return size + sum + long(height);
+    };
+
+    BENCHMARK("Tree cached aggregate query")
+    {
+        return t->aggregate();
+    };
+
+    BENCHMARK("Tree aggregate after an update two levels down")
+    {
+        inner->modifyContents([](int &v) { v++; });
+        return t->aggregate();
+    };
+}
+
+TEST_CASE("Tree label queries", "[tree]")
+{
+    std::unique_ptr<Tree<int>> scanned(buildTree());
+    std::unique_ptr<Tree<int>> indexed(buildTree());
+    indexed->setLabelIndexing(true);
+
+    for(const char *pattern : { "label3/*/label7", "**/label7", "**/label*" })
+    {
+        BENCHMARK(std::string("Tree query ") + pattern + " walking the children maps")
+        {
+            return scanned->query(pattern).size();
+        };
+
+        BENCHMARK(std::string("Tree query ") + pattern + " with the label index")
+        {
+            return indexed->query(pattern).size();
+        };
+    }
+}
@@ -0,0 +1,44 @@
+#include "alloccounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local std::size_t allocations = 0;
+
+    void *allocate(std::size_t size)
+    {
+        allocations++;
+        if(void *p = std::malloc(size ? size : 1))
+            return p;
+        throw std::bad_alloc();
+    }
+
+    void *allocate(std::size_t size, std::align_val_t align)
+    {
+        allocations++;
+        std::size_t a = static_cast<std::size_t>(align);
+        if(void *p = std::aligned_alloc(a, (size + a - 1) / a * a))
+            return p;
+        throw std::bad_alloc();
+    }
+}
+
+std::size_t AllocCounter::count() { return allocations; }
+
+void *operator new(std::size_t size)   { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept   { try { return allocate(size); } catch(...) { return nullptr; } }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { try { return allocate(size); } catch(...) { return nullptr; } }
+void *operator new(std::size_t size, std::align_val_t align)   { return allocate(size, align); }
+void *operator new[](std::size_t size, std::align_val_t align) { return allocate(size, align); }
+
+void operator delete(void *p) noexcept   { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept   { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept   { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept   { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
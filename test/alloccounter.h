@@ -0,0 +1,34 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+
+namespace AllocCounter
+{
+    /**
+     * @brief count Number of calls to any global operator new on this thread so far
+     * @return
+     */
+    std::size_t count();
+}
+
+/**
+ * @brief REQUIRE_ALLOCS Requires expr to call global operator new exactly n times
+ */
+#define REQUIRE_ALLOCS(n, expr)                                         \
+    do {                                                                \
+        std::size_t alloc_counter_before = AllocCounter::count();       \
+        expr;                                                           \
+        std::size_t alloc_counter_made = AllocCounter::count() - alloc_counter_before; \
+        INFO(#expr " allocated " << alloc_counter_made << " times");    \
+        REQUIRE(alloc_counter_made == std::size_t(n));                  \
+    } while(false)
+
+/**
+ * @brief REQUIRE_NO_ALLOC Requires expr not to call global operator new
+ */
+#define REQUIRE_NO_ALLOC(expr) REQUIRE_ALLOCS(0, expr)
+
+#endif // ALLOCCOUNTER_H
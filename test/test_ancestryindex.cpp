@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+
+#include "types/ancestryindex.h"
+
+using namespace Types;
+
+TEST_CASE("Ancestry index queries")
+{
+    Tree<int, int> t(0);
+    Tree<int, int> *a = t.emplaceChild(1);
+    Tree<int, int> *b = t.emplaceChild(2);
+    Tree<int, int> *a1 = a->emplaceChild(11);
+    Tree<int, int> *a2 = a->emplaceChild(12);
+    Tree<int, int> *a21 = a2->emplaceChild(121);
+
+    AncestryIndex<int, int> index(t);
+
+    REQUIRE(index.size() == 6);
+    REQUIRE(index.valid());
+
+    SECTION("Depth")
+    {
+        REQUIRE(index.depth(&t) == 0);
+        REQUIRE(index.depth(b) == 1);
+        REQUIRE(index.depth(a21) == 3);
+    }
+
+    SECTION("Is ancestor")
+    {
+        REQUIRE(index.isAncestor(&t, a21));
+        REQUIRE(index.isAncestor(a, a21));
+        REQUIRE(index.isAncestor(a2, a2));
+        REQUIRE(!index.isAncestor(a1, a21));
+        REQUIRE(!index.isAncestor(a21, a));
+        REQUIRE(!index.isAncestor(b, a1));
+    }
+
+    SECTION("Lowest common ancestor")
+    {
+        REQUIRE(index.lca(a1, a21) == a);
+        REQUIRE(index.lca(a21, a1) == a);
+        REQUIRE(index.lca(a21, b) == &t);
+        REQUIRE(index.lca(a2, a21) == a2);
+        REQUIRE(index.lca(&t, &t) == &t);
+    }
+
+    SECTION("Invalidation")
+    {
+        Tree<int, int> *b1 = b->emplaceChild(21);
+        REQUIRE(!index.valid());
+        REQUIRE(index.lca(b1, a1) == &t);
+        REQUIRE(index.depth(b1) == 2);
+        REQUIRE(index.valid());
+
+        delete a2;
+        REQUIRE(index.size() == 5);
+        REQUIRE(index.lca(a1, b1) == &t);
+        REQUIRE_THROWS(index.depth(a21));
+    }
+
+    SECTION("Other trees do not invalidate")
+    {
+        Tree<int, int> other(0);
+        other.emplaceChild(1);
+        delete other.emplaceChild(2);
+        REQUIRE(index.valid());
+
+        AncestryIndex<int, int> second(other);
+        REQUIRE(second.size() == 2);
+        a1->emplaceChild(111);
+        REQUIRE(second.valid());
+        REQUIRE(!index.valid());
+    }
+}
+
+TEST_CASE("Ancestry index lifetime")
+{
+    Tree<int, int> *t = new Tree<int, int>(0);
+    Tree<int, int> *a = t->emplaceChild(1);
+    a->emplaceChild(11);
+
+    REQUIRE_THROWS(AncestryIndex<int, int>(*a));
+
+    AncestryIndex<int, int> index(*t);
+    REQUIRE(index.size() == 3);
+
+    SECTION("Copies share the watch")
+    {
+        AncestryIndex<int, int> copy(index);
+        AncestryIndex<int, int> assigned(copy);
+        assigned = index;
+
+        a->emplaceChild(12);
+        REQUIRE(!copy.valid());
+        REQUIRE(copy.size() == 4);
+        REQUIRE(assigned.size() == 4);
+        REQUIRE(index.depth(a) == 1);
+    }
+
+    SECTION("Moved children follow their new tree")
+    {
+        Tree<int, int> other(5);
+        AncestryIndex<int, int> moved(other);
+        REQUIRE(moved.size() == 1);
+
+        other = std::move(*t);
+        REQUIRE(index.size() == 1);
+        REQUIRE(moved.size() == 3);
+        REQUIRE(moved.depth(a) == 1);
+
+        a->emplaceChild(12);
+        REQUIRE(index.valid());
+        REQUIRE(!moved.valid());
+        REQUIRE(moved.size() == 4);
+    }
+
+    SECTION("The index outlives its tree")
+    {
+        delete t;
+        t = nullptr;
+
+        REQUIRE(!index.valid());
+        REQUIRE_THROWS(index.size());
+        REQUIRE_THROWS(index.depth(a));
+    }
+
+    delete t;
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch.hpp>
+
+#include "types/bitstack.h"
+
+#include <cstdlib>
+#include <deque>
+
+using namespace Types;
+
+TEST_CASE("BitStack push and pull")
+{
+    BitStack stack;
+    std::deque<bool> model;   // front is the top
+
+    srand(11);
+    for(int i = 0; i < 5000; i++)
+    {
+        bool val = rand() & 1;
+        switch(rand() % 5)
+        {
+        case 0: case 1: stack.push_top(val);    model.push_front(val); break;
+        case 2:         stack.push_bottom(val); model.push_back(val);  break;
+        case 3:
+            if(model.size()) { REQUIRE(stack.pull_top() == model.front()); model.pop_front(); }
+            break;
+        case 4:
+            if(model.size()) { REQUIRE(stack.pull_bottom() == model.back()); model.pop_back(); }
+            break;
+        }
+
+        if(i % 997 == 0)
+            stack.reverse(), std::reverse(model.begin(), model.end());
+    }
+
+    REQUIRE(stack.size() == model.size());
+    for(std::size_t i = 0; i < model.size(); i++)
+        REQUIRE(stack[i] == model[i]);
+
+    REQUIRE_THROWS(stack[model.size()]);
+}
+
+TEST_CASE("BitStack count and find")
+{
+    BitStack forward(8), backward(8);
+    backward.reverse();
+
+    for(int i = 0; i < 300; i++)
+    {
+        forward.push_top(i % 3 == 0);
+        backward.push_top(i % 3 == 0);
+    }
+
+    for(BitStack *stack : { &forward, &backward })
+    {
+        REQUIRE(stack->count() == 100);
+        REQUIRE(stack->count(false) == 200);
+
+        REQUIRE(stack->find(true) == 2);
+        REQUIRE(stack->find(false) == 0);
+
+        stack->set_at(0, true);
+        REQUIRE(stack->find(true) == 0);
+        REQUIRE(stack->count() == 101);
+    }
+
+    REQUIRE(forward == backward);
+
+    BitStack zeros;
+    for(int i = 0; i < 200; i++)
+        zeros.push_bottom(false);
+    REQUIRE(zeros.find(true) == BitStack::npos);
+
+    zeros.push_bottom(true);
+    REQUIRE(zeros.find(true) == 200);
+    REQUIRE(BitStack().find(false) == BitStack::npos);
+}
+
+TEST_CASE("BitStack memory")
+{
+    BitStack stack(1 << 16);
+
+    for(int i = 0; i < (1 << 16); i++)
+        stack.push_top(i & 1);
+
+    std::size_t capacity = stack.capacity();
+    REQUIRE(capacity / 8 <= 2 * (1 << 16) / 8 + 16);
+
+    for(int i = 0; i < 100000; i++)
+    {
+        stack.push_top(true);
+        stack.pop_bottom();
+    }
+    REQUIRE(stack.capacity() <= 2 * capacity);
+    REQUIRE(stack.count() == (1 << 16));
+
+    BitStack copy = stack, moved = std::move(copy);
+    REQUIRE(moved == stack);
+    REQUIRE(copy.empty());
+
+    BitStack from_moved = copy;
+    REQUIRE(from_moved.empty());
+    from_moved.push_top(false);
+    REQUIRE(from_moved.count() == 0);
+
+    copy.push_bottom(true);
+    REQUIRE(copy.pull_top());
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+
+#include "types/stack.h"
+
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <vector>
+
+using namespace Types;
+
+static_assert(std::random_access_iterator<StridedIterator<int>>);
+static_assert(std::random_access_iterator<ChunkView<int>::Iterator>);
+
+TEST_CASE("Strided iteration")
+{
+    int array[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+    SECTION("View")
+    {
+        StridedView<int> forward(array + 1, 3, 3);
+        REQUIRE(std::vector<int>(forward.begin(), forward.end()) == std::vector<int>{ 1, 4, 7 });
+
+        StridedView<int> backward(array + 9, -4, 3);
+        REQUIRE(std::vector<int>(backward.begin(), backward.end()) == std::vector<int>{ 9, 5, 1 });
+        REQUIRE(backward[1] == 5);
+    }
+
+    SECTION("Stack")
+    {
+        Stack<int> forward(4), backward(4);
+        backward.reverse();
+        for(int i = 0; i < 10; i++)
+        {
+            forward.push_top(i);
+            backward.push_top(i);
+        }
+
+        std::vector<int> expected = { 8, 6, 4, 2, 0 };
+        StridedView<int> f = forward.strided(2, 1), b = backward.strided(2, 1);
+        REQUIRE(std::vector<int>(f.begin(), f.end()) == expected);
+        REQUIRE(std::vector<int>(b.begin(), b.end()) == expected);
+
+        REQUIRE(forward.strided(4).size() == 3);
+        REQUIRE(forward.strided(3, 10).empty());
+        REQUIRE_THROWS(forward.strided(0));
+
+        for(int &x : forward.strided(5))
+            x = -1;
+        REQUIRE(forward[0] == -1);
+        REQUIRE(forward[5] == -1);
+        REQUIRE(forward.count(-1) == 2);
+    }
+}
+
+TEST_CASE("Chunked iteration")
+{
+    Stack<int> forward(4), backward(4);
+    backward.reverse();
+    for(int i = 0; i < 10; i++)
+    {
+        forward.push_top(i);
+        backward.push_top(i);
+    }
+
+    for(Stack<int> *stack : { &forward, &backward })
+    {
+        ChunkView<int> chunks = stack->chunks(4);
+        REQUIRE(chunks.size() == 3);
+
+        std::vector<int> top_down;
+        std::vector<std::size_t> sizes;
+        for(Chunk<int> c : chunks)
+        {
+            sizes.push_back(c.size());
+            top_down.insert(top_down.end(), c.begin(), c.end());
+        }
+
+        REQUIRE(sizes == std::vector<std::size_t>{ 4, 4, 2 });
+        REQUIRE(top_down == std::vector<int>{ 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 });
+
+        REQUIRE(chunks[1][0] == 5);
+        REQUIRE(chunks[2].getDirection() == !stack->getDirection());
+    }
+
+    SECTION("Blocks are contiguous memory")
+    {
+        std::span<int> top = forward.chunks(4)[0];
+        REQUIRE(top.size() == 4);
+        REQUIRE(top.front() == 6);
+        REQUIRE(top.back() == 9);
+        REQUIRE(std::accumulate(top.begin(), top.end(), 0) == 30);
+
+        std::span<int> bottom = backward.chunks(4)[2];
+        REQUIRE(bottom.front() == 1);
+        REQUIRE(bottom.back() == 0);
+    }
+
+    SECTION("Empty stack")
+    {
+        Stack<int> empty;
+        REQUIRE(empty.chunks(3).empty());
+        REQUIRE(empty.chunks(3).begin() == empty.chunks(3).end());
+        REQUIRE_THROWS(empty.chunks(0));
+    }
+}
@@ -0,0 +1,80 @@
+#include <catch2/catch.hpp>
+
+#include "types/compacttree.h"
+
+#include <string>
+#include <vector>
+
+using namespace Types;
+
+TEST_CASE("Compact tree node size")
+{
+    REQUIRE(sizeof(Tree<void*, ForwardOnly>) == 4 * sizeof(void*));
+    REQUIRE(sizeof(Tree<void*, void>) == 6 * sizeof(void*));
+    REQUIRE(sizeof(Tree<void*, void>) < sizeof(Tree<void*, int>));
+}
+
+TEST_CASE("Compact tree member access")
+{
+    Tree<int, void> t(1);
+    t.addChild(2);
+    t.addChildren({3, 4});
+    t.emplaceChild(5)->addChild(6);
+
+    std::vector<int> v, v_comp = {2, 3, 4, 5};
+    for(auto &c : t) v.push_back(*c);
+    REQUIRE(v == v_comp);
+
+    auto it = t.end();
+    it--;
+    REQUIRE(**it == 5);
+    REQUIRE(**it->begin() == 6);
+    REQUIRE(it->begin()->getParent() == it.getPtr());
+
+    SECTION("Deletion")
+    {
+        delete t.begin().getPtr();
+        delete (--t.end()).getPtr();
+
+        v.clear(); v_comp = {3, 4};
+        for(auto &c : t) v.push_back(*c);
+        REQUIRE(v == v_comp);
+        REQUIRE(**(--t.end()) == 4);
+    }
+
+    SECTION("Copy and move")
+    {
+        Tree<int, void> t2 = t;
+        REQUIRE(t2 == t);
+
+        Tree<int, void> t3(0);
+        t3 = std::move(t2);
+        REQUIRE(t3 == t);
+        REQUIRE(t3.begin()->getParent() == &t3);
+        REQUIRE(t2.begin().getPtr() == nullptr);
+
+        t3.begin()->addChild(7);
+        REQUIRE(t3 != t);
+    }
+}
+
+TEST_CASE("Forward only tree")
+{
+    Tree<std::string, ForwardOnly> t("a");
+    t.addChildren(std::vector<std::string>{"b", "c", "d"});
+    t.emplaceChild(2, 'e');
+
+    auto it = t.begin();
+    it++;
+    delete it.getPtr();
+
+    std::vector<std::string> v, v_comp = {"b", "d", "ee"};
+    for(auto &c : t) v.push_back(*c);
+    REQUIRE(v == v_comp);
+
+    Tree<std::string, ForwardOnly> t2 = t;
+    REQUIRE(t2 == t);
+    delete t2.begin().getPtr();
+    REQUIRE(t2 != t);
+    REQUIRE(**t2.begin() == "d");
+}
@@ -0,0 +1,173 @@
+#include <catch2/catch.hpp>
+
+#include "types/cowstack.h"
+#include "alloccounter.h"
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Types;
+
+TEST_CASE("CowStack copies share the buffer")
+{
+    CowStack<std::string> stack = { "a", "b", "c" };
+
+    CowStack<std::string> snapshot(4);
+    REQUIRE_NO_ALLOC(snapshot = stack);
+    REQUIRE(snapshot.shares(stack));
+    REQUIRE(stack.useCount() == 2);
+
+    SECTION("Reads do not clone")
+    {
+        const CowStack<std::string> &c = stack;
+        REQUIRE_NO_ALLOC(c[0]);
+        REQUIRE(c[0] == "c");
+        REQUIRE(c.view().size() == 3);
+        REQUIRE(snapshot.shares(stack));
+        REQUIRE(snapshot == stack);
+    }
+
+    SECTION("First write clones")
+    {
+        stack.push_top("d");
+        REQUIRE(!snapshot.shares(stack));
+        REQUIRE(stack.useCount() == 1);
+        REQUIRE(snapshot.useCount() == 1);
+
+        REQUIRE(stack.size() == 4);
+        REQUIRE(snapshot.size() == 3);
+        REQUIRE(snapshot[0] == "c");
+        REQUIRE(snapshot != stack);
+
+        REQUIRE_NO_ALLOC(stack.pop_top());
+        REQUIRE(stack == snapshot);
+    }
+
+    SECTION("Writes by index clone")
+    {
+        snapshot.set(2, "z");
+        REQUIRE(stack[2] == "a");
+        REQUIRE(snapshot.view()[2] == "z");
+
+        snapshot.modify([](Stack<std::string> &s) { s[0] = "y"; s.push_bottom("x"); });
+        REQUIRE(snapshot[0] == "y");
+        REQUIRE(snapshot.size() == 4);
+        REQUIRE(stack[0] == "c");
+    }
+
+    SECTION("References taken before a copy do not reach the copy")
+    {
+        CowStack<std::string> own = { "p", "q" };
+        own.set(0, "r");
+        const std::string &top = own[0];
+
+        CowStack<std::string> copy = own;
+        own.set(0, "s");
+        REQUIRE(copy[0] == "r");
+        REQUIRE(top == "r");
+        REQUIRE(own[0] == "s");
+    }
+
+    SECTION("Pulling from an empty shared stack does not clone")
+    {
+        CowStack<std::string> empty(0);
+        CowStack<std::string> copy = empty;
+        REQUIRE_NO_ALLOC(REQUIRE(empty.pull_top().empty()));
+        REQUIRE_NO_ALLOC(REQUIRE(empty.pull_bottom().empty()));
+        REQUIRE(copy.shares(empty));
+    }
+
+    SECTION("Direction survives cloning")
+    {
+        stack.reverse();
+        REQUIRE(stack[0] == "a");
+        REQUIRE(snapshot[0] == "c");
+
+        CowStack<std::string> again = stack;
+        again.push_top("0");
+        REQUIRE(again[0] == "0");
+        REQUIRE(again[1] == "a");
+        REQUIRE(again.pull_bottom() == "c");
+        REQUIRE(stack.view()[2] == "c");
+    }
+
+    SECTION("Clear leaves the shared buffer to the copies")
+    {
+        stack.clear();
+        REQUIRE(stack.empty());
+        REQUIRE(snapshot.size() == 3);
+    }
+}
+
+TEST_CASE("CowStack Stack copies are deep and keep the source")
+{
+    Stack<std::string> original = { "one", "two" };
+    Stack<std::string> copy = original;
+
+    REQUIRE(original[0] == "two");
+    REQUIRE(copy == original);
+
+    CowStack<std::string> cow(std::move(copy));
+    REQUIRE(cow[1] == "one");
+
+    original.reverse();
+    Stack<std::string> reversed = original;
+    REQUIRE(reversed.getDirection() == false);
+    REQUIRE(reversed[0] == "one");
+    reversed.push_top("zero");
+    REQUIRE(reversed[1] == "one");
+}
+
+TEST_CASE("CowStack moves do not allocate")
+{
+    CowStack<std::string> stack = { "a", "b" };
+    static_assert(std::is_nothrow_move_constructible<CowStack<std::string>>::value, "");
+    static_assert(std::is_same<decltype(*stack.begin()), const std::string &>::value, "");
+
+    std::optional<CowStack<std::string>> moved;
+    REQUIRE_NO_ALLOC(moved.emplace(std::move(stack)));
+    REQUIRE(moved->size() == 2);
+    REQUIRE(moved->useCount() == 1);
+
+    REQUIRE(stack.empty());
+    REQUIRE(stack.useCount() == 0);
+    REQUIRE(stack.begin() == stack.end());
+    REQUIRE(stack == CowStack<std::string>(0));
+
+    CowStack<std::string> copy = stack;
+    REQUIRE(copy.empty());
+
+    stack.push_top("c");
+    REQUIRE(stack[0] == "c");
+    REQUIRE(stack.useCount() == 1);
+    REQUIRE(copy.empty());
+}
+
+TEST_CASE("CowStack snapshots across threads")
+{
+    CowStack<int> stack;
+    for(int i = 0; i < 1000; i++)
+        stack.push_top(i);
+
+    std::vector<std::thread> threads;
+    std::vector<long> sums(4);
+    for(int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([snapshot = stack, &sums, t]() mutable {
+            sums[t] = snapshot.view().sum();
+            snapshot.push_top(t);
+            sums[t] += snapshot.view().size();
+        });
+    }
+
+    stack.pop_top();
+    for(std::thread &t : threads)
+        t.join();
+
+    for(long s : sums)
+        REQUIRE(s == 499500 + 1001);
+    REQUIRE(stack.size() == 999);
+    REQUIRE(stack.useCount() == 1);
+}
@@ -2,6 +2,10 @@
 
 #include "types/directionaliterator.h"
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
 using namespace Types;
 
 int test_array[] = { 1, 2, 3, 4, 5 };
@@ -211,3 +215,36 @@ TEST_CASE("Iterator comparisom")
         REQUIRE(!(backward1 <= backward2));
     }
 }
+
+static_assert(std::random_access_iterator<DirectionalIterator<int>>);
+static_assert(std::random_access_iterator<DirectionalIterator<const int>>);
+static_assert(std::contiguous_iterator<ContiguousIterator<int>>);
+static_assert(std::contiguous_iterator<ContiguousIterator<const int>>);
+
+TEST_CASE("Iterator standard algorithms")
+{
+    int sort_array[] = { 3, 5, 1, 4, 2 };
+
+    SECTION("Sorting backward")
+    {
+        std::ranges::sort(DirectionalIterator<int>(sort_array + 4, false), DirectionalIterator<int>(sort_array - 1, false));
+        REQUIRE(sort_array[0] == 5);
+        REQUIRE(sort_array[4] == 1);
+    }
+
+    SECTION("Contiguous copy")
+    {
+        int copy[5] = { };
+        std::copy(ContiguousIterator<int>(sort_array), ContiguousIterator<int>(sort_array + 5), ContiguousIterator<int>(copy));
+        REQUIRE(std::equal(copy, copy + 5, sort_array));
+        REQUIRE(std::to_address(ContiguousIterator<int>(sort_array + 2)) == sort_array + 2);
+    }
+
+    SECTION("Index and difference")
+    {
+        const DirectionalIterator<int> backward(sort_array + 4, false);
+        REQUIRE(backward[2] == 1);
+        REQUIRE(2 + backward == backward + 2);
+        REQUIRE((backward + 3) - backward == 3);
+    }
+}
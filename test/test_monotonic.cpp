@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+
+#include "types/monotonic.h"
+#include "alloccounter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+using namespace Types;
+
+TEST_CASE("MonotonicStack next greater element")
+{
+    std::vector<int> values = { 2, 7, 3, 5, 4, 6, 8, 1 };
+    std::vector<int> next_greater(values.size(), -1);
+
+    MonotonicStack<std::size_t, std::function<bool(std::size_t, std::size_t)>> stack(8,
+        [&](std::size_t a, std::size_t b) { return values[a] < values[b]; });
+
+    for(std::size_t i = 0; i < values.size(); i++)
+        stack.push(i, [&](std::size_t j) { next_greater[j] = values[i]; });
+
+    REQUIRE(next_greater == std::vector<int>{ 7, 8, 5, 6, 6, 8, -1, -1 });
+    REQUIRE(stack.size() == 2);
+    REQUIRE(values[stack.bottom()] == 8);
+    REQUIRE(values[stack.top()] == 1);
+}
+
+TEST_CASE("MonotonicStack order")
+{
+    MonotonicStack<int, std::greater<int>> stack;
+
+    REQUIRE(stack.push(5) == 0);
+    REQUIRE(stack.push(3) == 1);
+    REQUIRE(stack.push(4) == 0);
+    REQUIRE(stack.push(4) == 0);
+    REQUIRE(stack.push(1) == 3);
+
+    REQUIRE(std::vector<int>(stack.begin(), stack.end()) == std::vector<int>{ 1 });
+
+    stack.pop_top();
+    REQUIRE(stack.empty());
+    REQUIRE_THROWS(stack.top());
+    REQUIRE_THROWS(stack.bottom());
+}
+
+TEST_CASE("MonotonicDeque sliding window")
+{
+    srand(3);
+    std::vector<int> values;
+    for(int i = 0; i < 500; i++)
+        values.push_back(rand() % 100);
+
+    SECTION("Maximum and minimum")
+    {
+        const std::size_t w = 7;
+        MonotonicDeque<int> max(w);
+        MonotonicDeque<int, std::greater<int>> min(w);
+
+        for(std::size_t i = 0; i < values.size(); i++)
+        {
+            max.push(values[i]);
+            min.push(values[i]);
+
+            auto first = values.begin() + (i + 1 > w ? i + 1 - w : 0), last = values.begin() + i + 1;
+            REQUIRE(max.front() == *std::max_element(first, last));
+            REQUIRE(min.front() == *std::min_element(first, last));
+            REQUIRE(max.front_position() + w > i);
+        }
+
+        REQUIRE(max.next_position() == values.size());
+        REQUIRE(max.size() <= w);
+    }
+
+    SECTION("Explicit positions and eviction")
+    {
+        MonotonicDeque<int> max;
+
+        max.push(9, 10);
+        max.push(4, 20);
+        max.push(6, 30);
+        REQUIRE(max.front() == 9);
+
+        max.evict_before(11);
+        REQUIRE(max.front() == 6);
+        REQUIRE(max.front_position() == 30);
+
+        max.evict_before(31);
+        REQUIRE(max.empty());
+        REQUIRE_THROWS(max.front());
+        REQUIRE(max.next_position() == 31);
+    }
+
+    SECTION("No allocation in steady state")
+    {
+        MonotonicDeque<int> max(16);
+        for(int i = 0; i < 1000; i++)
+            max.push(-i);
+
+        REQUIRE_NO_ALLOC(for(int i = 0; i < 10000; i++) max.push(i));
+        REQUIRE_NO_ALLOC(for(int i = 0; i < 10000; i++) max.push(10000 - i));
+        REQUIRE(max.size() == 16);
+    }
+}
@@ -0,0 +1,121 @@
+#include <catch2/catch.hpp>
+
+#include "types/objectpool.h"
+#include "alloccounter.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Types;
+
+namespace
+{
+    struct Counted
+    {
+        static inline std::atomic<int> alive{0};
+        std::string payload;
+
+        Counted() { alive++; }
+        ~Counted() { alive--; }
+    };
+}
+
+TEST_CASE("ObjectPool recycles objects")
+{
+    {
+        ObjectPool<Counted> pool(4);
+
+        Counted *a = pool.acquire();
+        a->payload = "kept";
+        pool.release(a);
+
+        REQUIRE(pool.acquire() == a);
+        REQUIRE(a->payload == "kept");
+        REQUIRE(pool.created() == 1);
+
+        std::vector<Counted*> many;
+        for(int i = 0; i < 20; i++)
+            many.push_back(pool.acquire());
+        for(Counted *c : many)
+            pool.release(c);
+
+        REQUIRE(pool.created() == 21);
+        REQUIRE(pool.cachedSize() < 8);
+        REQUIRE(pool.cachedSize() + pool.depotSize() == 20);
+
+        pool.release(a);
+        REQUIRE(Counted::alive == 21);
+    }
+
+    REQUIRE(Counted::alive == 0);
+}
+
+TEST_CASE("ObjectPool handles")
+{
+    ObjectPool<std::string> pool(2, [] { return new std::string("fresh"); });
+
+    std::string *first;
+    {
+        ObjectPool<std::string>::Handle h = pool.get();
+        REQUIRE(*h == "fresh");
+        h->append("!");
+        first = h.get();
+
+        ObjectPool<std::string>::Handle moved = std::move(h);
+        REQUIRE(!h);
+        REQUIRE(moved.get() == first);
+    }
+
+    ObjectPool<std::string>::Handle again = pool.get();
+    REQUIRE(again.get() == first);
+    REQUIRE(*again == "fresh!");
+
+    again.reset();
+    REQUIRE(!again);
+    REQUIRE(pool.created() == 1);
+
+    REQUIRE_NO_ALLOC(for(int i = 0; i < 100; i++) { ObjectPool<std::string>::Handle h = pool.get(); });
+}
+
+TEST_CASE("ObjectPool across threads")
+{
+    {
+        ObjectPool<Counted> pool(8);
+        std::atomic<int> ok{0};
+
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 4; t++)
+        {
+            threads.emplace_back([&pool, &ok, t] {
+                std::vector<Counted*> held;
+                for(int round = 0; round < 200; round++)
+                {
+                    for(int i = 0; i < 10 + (round + t) % 7; i++)
+                        held.push_back(pool.acquire());
+                    for(Counted *c : held)
+                        pool.release(c);
+                    held.clear();
+                }
+                ok++;
+            });
+        }
+
+        for(std::thread &t : threads)
+            t.join();
+
+        REQUIRE(ok == 4);
+        REQUIRE(pool.created() <= 4 * (16 + 3 * 8));
+        REQUIRE(std::size_t(Counted::alive) == pool.created());
+        REQUIRE(pool.depotSize() == pool.created());
+
+        // Objects released by another thread end up in this thread's cache
+        Counted *c = nullptr;
+        std::thread([&] { c = pool.acquire(); }).join();
+        pool.release(c);
+        REQUIRE(pool.cachedSize() == 1);
+    }
+
+    REQUIRE(Counted::alive == 0);
+}
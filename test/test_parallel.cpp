@@ -0,0 +1,161 @@
+#include <catch2/catch.hpp>
+
+#include "types/parallel.h"
+#include "types/stack.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Types;
+
+TEST_CASE("ThreadPool runs every part once")
+{
+    Parallel::ThreadPool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    std::vector<std::atomic<int>> calls(100);
+    pool.run(calls.size(), [&](std::size_t i) { calls[i]++; });
+
+    for(std::atomic<int> &c : calls)
+        REQUIRE(c == 1);
+
+    SECTION("Nested jobs run serially")
+    {
+        std::atomic<int> inner{0};
+        pool.run(8, [&](std::size_t) { pool.run(4, [&](std::size_t) { inner++; }); });
+        REQUIRE(inner == 32);
+    }
+
+    SECTION("Exceptions reach the caller after all parts finished")
+    {
+        std::atomic<int> finished{0};
+        REQUIRE_THROWS_WITH(pool.run(16, [&](std::size_t i) {
+            if(i == 3)
+                throw std::string("part failed");
+            finished++;
+        }), "part failed");
+        REQUIRE(finished == 15);
+
+        pool.run(4, [&](std::size_t) { finished++; });
+        REQUIRE(finished == 19);
+    }
+
+    SECTION("Jobs from several threads")
+    {
+        std::atomic<int> total{0};
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 4; t++)
+            threads.emplace_back([&] { for(int r = 0; r < 50; r++) pool.run(8, [&](std::size_t) { total++; }); });
+        for(std::thread &t : threads)
+            t.join();
+        REQUIRE(total == 4 * 50 * 8);
+    }
+}
+
+TEST_CASE("Parallel partitions")
+{
+    Parallel::ThreadPool pool(4);
+    Parallel::Policy policy{ &pool, 100 };
+
+    REQUIRE(policy.partitions(0) == 1);
+    REQUIRE(policy.partitions(199) == 1);
+    REQUIRE(policy.partitions(300) == 3);
+    REQUIRE(policy.partitions(100000) == 4);
+
+    std::size_t covered = 0;
+    for(std::size_t i = 0; i < 3; i++)
+    {
+        REQUIRE(Parallel::part(10, 3, i) == covered);
+        covered = Parallel::part(10, 3, i + 1);
+    }
+    REQUIRE(covered == 10);
+}
+
+TEST_CASE("Stack parallel algorithms")
+{
+    Parallel::ThreadPool pool(4);
+    Parallel::Policy policy{ &pool, 64 };
+
+    bool direction = GENERATE(true, false);
+    Stack<int> stack;
+    stack.setDirection(direction);
+    for(int i = 0; i < 1000; i++)
+        stack.push_top((i * 7919) % 1000);
+
+    std::vector<int> expected(stack.begin(), stack.end());
+
+    SECTION("for_each visits every element")
+    {
+        Parallel::for_each(stack, [](int &v) { v *= 2; }, policy);
+
+        for(std::size_t i = 0; i < expected.size(); i++)
+            REQUIRE(stack[i] == 2 * expected[i]);
+    }
+
+    SECTION("transform keeps the order and direction")
+    {
+        Stack<std::string> out = Parallel::transform(stack, [](const int &v) { return std::to_string(v); }, policy);
+
+        REQUIRE(out.size() == stack.size());
+        REQUIRE(out.getDirection() == direction);
+        for(std::size_t i = 0; i < expected.size(); i++)
+            REQUIRE(out[i] == std::to_string(expected[i]));
+
+        out.push_top("top");
+        REQUIRE(out[0] == "top");
+    }
+
+    SECTION("sort orders from the top")
+    {
+        Parallel::sort(stack, std::less<int>(), policy);
+        std::sort(expected.begin(), expected.end());
+        REQUIRE(std::vector<int>(stack.begin(), stack.end()) == expected);
+
+        Parallel::sort(stack, std::greater<int>(), policy);
+        REQUIRE(std::vector<int>(stack.begin(), stack.end()) == std::vector<int>(expected.rbegin(), expected.rend()));
+        REQUIRE(stack.getDirection() == direction);
+    }
+
+    SECTION("reduce combines from the top")
+    {
+        REQUIRE(Parallel::reduce(stack, 0L, std::plus<long>(), policy) == long(stack.sum()));
+
+        Stack<std::string> letters = Parallel::transform(stack, [](const int &v) { return std::string(1, char('a' + v % 26)); }, policy);
+
+        std::string serial;
+        for(int v : expected)
+            serial += char('a' + v % 26);
+
+        std::string folded = Parallel::reduce(letters, std::string(">"), std::plus<std::string>(), policy);
+        serial.insert(serial.begin(), '>');
+        REQUIRE(folded == serial);
+    }
+}
+
+TEST_CASE("Stack parallel algorithms below the threshold")
+{
+    Parallel::ThreadPool pool(4);
+    Parallel::Policy policy{ &pool, 1 << 20 };
+
+    Stack<int> stack;
+    for(int i = 0; i < 1000; i++)
+        stack.push_top(i);
+
+    std::mutex lock;
+    std::set<std::thread::id> ids;
+    Parallel::for_each(stack, [&](int &) { std::lock_guard<std::mutex> guard(lock); ids.insert(std::this_thread::get_id()); }, policy);
+
+    REQUIRE(ids.size() == 1);
+    REQUIRE(*ids.begin() == std::this_thread::get_id());
+
+    Stack<int> empty;
+    REQUIRE(Parallel::reduce(empty, 5, std::plus<int>(), policy) == 5);
+    REQUIRE(Parallel::transform(empty, [](const int &v) { return v; }, policy).size() == 0);
+    Parallel::sort(empty, std::less<int>(), policy);
+}
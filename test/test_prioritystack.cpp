@@ -0,0 +1,149 @@
+#include <catch2/catch.hpp>
+
+#include "types/prioritystack.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace Types;
+
+TEST_CASE("PriorityStack push and pull")
+{
+    PriorityStack<int> max_heap;
+    PriorityStack<int, std::greater<int>, 2> min_heap(2);
+
+    std::vector<int> values;
+    srand(7);
+    for(int i = 0; i < 200; i++)
+    {
+        int v = rand() % 1000;
+        values.push_back(v);
+        max_heap.push(v);
+        min_heap.push(v);
+    }
+
+    REQUIRE(max_heap.size() == 200);
+    REQUIRE(max_heap.top() == *std::max_element(values.begin(), values.end()));
+
+    std::vector<int> descending, ascending;
+    while(!max_heap.empty())
+    {
+        descending.push_back(max_heap.pull_top());
+        ascending.push_back(min_heap.pull_top());
+    }
+
+    std::sort(values.begin(), values.end());
+    REQUIRE(ascending == values);
+
+    std::reverse(values.begin(), values.end());
+    REQUIRE(descending == values);
+
+    REQUIRE_THROWS(max_heap.top());
+    REQUIRE_THROWS(max_heap.pull_top());
+    max_heap.pop_top();
+}
+
+TEST_CASE("PriorityStack heapify")
+{
+    Stack<std::string> stack = { "pear", "apple", "fig", "quince", "banana", "kiwi", "cherry" };
+    stack.reverse();
+
+    PriorityStack<std::string, std::greater<std::string>> heap(std::move(stack));
+    REQUIRE(heap.size() == 7);
+    REQUIRE(heap.contains({6}));
+
+    std::vector<std::string> sorted;
+    while(!heap.empty())
+        sorted.push_back(heap.pull_top());
+
+    REQUIRE(sorted == std::vector<std::string>{ "apple", "banana", "cherry", "fig", "kiwi", "pear", "quince" });
+
+    heap.heapify(Stack<std::string>{ "b" });
+    REQUIRE(heap.pull_top() == "b");
+
+    heap.heapify(Stack<std::string>());
+    REQUIRE(heap.empty());
+}
+
+TEST_CASE("PriorityStack handles")
+{
+    PriorityStack<int, std::greater<int>> heap;
+
+    std::vector<PriorityStack<int, std::greater<int>>::Handle> handles;
+    for(int i = 0; i < 20; i++)
+        handles.push_back(heap.push(100 + i));
+
+    SECTION("Decrease key")
+    {
+        heap.decrease_key(handles[15], 1);
+        REQUIRE(heap.top() == 1);
+        REQUIRE(heap.topHandle() == handles[15]);
+        REQUIRE(heap.get(handles[15]) == 1);
+        REQUIRE_THROWS(heap.decrease_key(handles[3], 500));
+
+        heap.pop_top();
+        REQUIRE(!heap.contains(handles[15]));
+        REQUIRE_THROWS(heap.get(handles[15]));
+        REQUIRE(heap.top() == 100);
+    }
+
+    SECTION("Update and erase")
+    {
+        heap.update(handles[0], 150);
+        REQUIRE(heap.top() == 101);
+
+        heap.erase(handles[1]);
+        heap.erase(handles[19]);
+        REQUIRE(heap.size() == 18);
+        REQUIRE_THROWS(heap.erase(handles[1]));
+
+        std::vector<int> out;
+        while(!heap.empty())
+            out.push_back(heap.pull_top());
+
+        REQUIRE(out.front() == 102);
+        REQUIRE(out.back() == 150);
+        REQUIRE(std::is_sorted(out.begin(), out.end()));
+    }
+
+    SECTION("Ids are reused, stale handles stay invalid")
+    {
+        heap.pop_top();
+        PriorityStack<int, std::greater<int>>::Handle h = heap.push(5);
+        REQUIRE(h.id == handles[0].id);
+        REQUIRE(h != handles[0]);
+        REQUIRE(heap.get(h) == 5);
+        REQUIRE(heap.get(handles[1]) == 101);
+
+        REQUIRE(!heap.contains(handles[0]));
+        REQUIRE_THROWS(heap.decrease_key(handles[0], 1));
+        REQUIRE_THROWS(heap.update(handles[0], 1));
+        REQUIRE_THROWS(heap.erase(handles[0]));
+        REQUIRE(heap.size() == 20);
+    }
+
+    SECTION("Clear and heapify invalidate all handles")
+    {
+        heap.clear();
+        PriorityStack<int, std::greater<int>>::Handle h = heap.push(7);
+        REQUIRE(!heap.contains(handles[h.id]));
+        REQUIRE(heap.contains(h));
+
+        heap.heapify(Stack<int>{ 3, 2, 1 });
+        REQUIRE(!heap.contains(h));
+        for(const auto &old : handles)
+            REQUIRE(!heap.contains(old));
+        REQUIRE(heap.contains(heap.topHandle()));
+        REQUIRE(heap.get(heap.topHandle()) == 1);
+
+        heap.erase(heap.topHandle());
+        REQUIRE(heap.top() == 2);
+        for(int i = 0; i < 30; i++)
+            heap.push(i);
+        REQUIRE(heap.size() == 32);
+        REQUIRE(heap.top() == 0);
+    }
+}
@@ -0,0 +1,155 @@
+#include <catch2/catch.hpp>
+
+#include "types/parallel.h"
+#include "types/soastack.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+using namespace Types;
+
+TEST_CASE("SoAStack push and pull")
+{
+    SoAStack<int, double, std::string> stack(2);
+
+    stack.push_top(1, 1.5, "one");
+    stack.push_top(std::make_tuple(2, 2.5, std::string("two")));
+    stack.push_bottom(0, 0.5, "zero");
+
+    for(int i = 3; i < 40; i++)
+        stack.push_top(i, i + 0.5, std::to_string(i));
+
+    REQUIRE(stack.size() == 40);
+    REQUIRE(stack.column<0>().size() == 40);
+    REQUIRE(stack.column<2>().size() == 40);
+
+    REQUIRE(std::get<0>(stack[0]) == 39);
+    REQUIRE(std::get<2>(stack[39]) == "zero");
+    REQUIRE_THROWS(stack[40]);
+
+    REQUIRE(stack.pull_top() == std::make_tuple(39, 39.5, std::string("39")));
+    REQUIRE(stack.pull_bottom() == std::make_tuple(0, 0.5, std::string("zero")));
+    REQUIRE(stack.size() == 38);
+
+    stack.reverse();
+    REQUIRE(std::get<2>(stack[0]) == "one");
+    REQUIRE(stack.getDirection() == false);
+
+    stack.clear();
+    REQUIRE(stack.empty());
+    REQUIRE_THROWS(stack.pull_top());
+}
+
+TEST_CASE("SoAStack columns and proxies")
+{
+    SoAStack<float, float, int> particles;
+    for(int i = 0; i < 100; i++)
+        particles.push_top(float(i), float(2 * i), i % 4);
+
+    SECTION("Per field passes")
+    {
+        REQUIRE(particles.column<0>().sum() == 4950.0f);
+        REQUIRE(particles.column<2>().count(3) == 25);
+
+        for(float *x = &*particles.column<0>().buffer_begin(), *e = x + particles.size(); x != e; x++)
+            *x += 1.0f;
+
+        REQUIRE(particles.column<0>().max() == 100.0f);
+        REQUIRE(std::get<0>(particles[0]) == 100.0f);
+
+        auto kinds = particles.column<2>();
+        Parallel::for_each(kinds, [](int &k) { k++; });
+        REQUIRE(kinds.view().count(4) == 25);
+        kinds.fill(0);
+        REQUIRE(kinds.sum() == 0);
+        REQUIRE(particles.size() == 100);
+        REQUIRE(std::get<1>(particles[0]) == 198.0f);
+    }
+
+    SECTION("Const columns")
+    {
+        const SoAStack<float, float, int> &view = particles;
+        auto xs = view.column<0>();
+
+        static_assert(std::is_same<decltype(xs[0]), const float&>::value, "const columns are read-only");
+        static_assert(std::is_same<decltype(*xs.begin()), const float&>::value, "const columns are read-only");
+        static_assert(std::is_same<decltype(*xs.buffer_begin()), const float&>::value, "const columns are read-only");
+        static_assert(std::is_same<decltype(xs.strided(2)[0]), const float&>::value, "const columns are read-only");
+        static_assert(std::is_same<decltype(xs.chunks(8)[0][0]), const float&>::value, "const columns are read-only");
+
+        REQUIRE(xs.sum() == 4950.0f);
+        REQUIRE(xs[0] == 99.0f);
+        REQUIRE(*xs.find(42.0f) == 42.0f);
+        REQUIRE(view.column<2>().count(3) == 25);
+        REQUIRE(xs.chunks(8).size() == 13);
+        REQUIRE(xs.view().size() == 100);
+        REQUIRE(Parallel::reduce(xs, 0.0f, std::plus<float>()) == 4950.0f);
+        REQUIRE(Parallel::transform(xs, [](float x) { return int(x); })[0] == 99);
+    }
+
+    SECTION("Whole records")
+    {
+        auto [x, y, kind] = particles[10];
+        x = -1.0f;
+        kind = 7;
+        REQUIRE(particles.column<0>()[10] == -1.0f);
+        REQUIRE(particles.column<2>()[10] == 7);
+        REQUIRE(y == 178.0f);
+
+        int sevens = 0;
+        for(auto record : particles)
+            sevens += std::get<2>(record) == 7;
+        REQUIRE(sevens == 1);
+
+        auto it = std::find_if(particles.begin(), particles.end(), [](const auto &r) { return std::get<0>(r) < 0; });
+        REQUIRE(it - particles.begin() == 10);
+        REQUIRE(std::get<1>(it[1]) == 176.0f);
+    }
+}
+
+namespace
+{
+    struct ThrowingCopy
+    {
+        static inline bool fail = false;
+        int value = 0;
+
+        ThrowingCopy() = default;
+        ThrowingCopy(int value) : value(value) { }
+        ThrowingCopy(const ThrowingCopy &) = default;
+
+        ThrowingCopy &operator=(const ThrowingCopy &other)
+        {
+            if(fail)
+                throw "copy failed";
+            value = other.value;
+            return *this;
+        }
+    };
+}
+
+TEST_CASE("SoAStack record pushes that throw keep the columns aligned")
+{
+    SoAStack<int, std::string, ThrowingCopy> stack(16);
+    stack.push_top(1, "one", 1);
+    stack.push_bottom(2, "two", 2);
+
+    ThrowingCopy::fail = true;
+    REQUIRE_THROWS(stack.push_top(3, "three", 3));
+    REQUIRE_THROWS(stack.push_bottom(4, "four", 4));
+    ThrowingCopy::fail = false;
+
+    REQUIRE(stack.size() == 2);
+    REQUIRE(stack.column<0>().size() == 2);
+    REQUIRE(stack.column<1>().size() == 2);
+    REQUIRE(stack.column<2>().size() == 2);
+    REQUIRE(std::get<1>(stack[0]) == "one");
+    REQUIRE(std::get<1>(stack[1]) == "two");
+
+    stack.push_top(5, "five", 5);
+    REQUIRE(std::get<0>(stack[0]) == 5);
+    REQUIRE(std::get<2>(stack[0]).value == 5);
+}
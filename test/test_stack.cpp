@@ -2,6 +2,20 @@
 
 #include "types/stack.h"
 
+#include "alloccounter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
 using namespace Types;
 
 TEST_CASE("Stack list constructor and basic member access")
@@ -214,3 +228,356 @@ TEST_CASE("Stack pull")
     REQUIRE(stack2.pull_bottom() == 0);
     REQUIRE(stack2.pull_bottom() == 0);
 }
+
+TEST_CASE("Stack drain")
+{
+    Stack<int> stack({1, 2, 3, 4, 5}, true);
+
+    SECTION("Top")
+    {
+        std::vector<int> v, v_comp = {5, 4, 3, 2, 1};
+        for(int i : stack.drain_top()) v.push_back(i);
+        REQUIRE(v == v_comp);
+        REQUIRE(stack.size() == 0);
+    }
+
+    SECTION("Bottom, stopping early")
+    {
+        std::vector<int> v, v_comp = {1, 2};
+        for(int i : stack.drain_bottom() | std::views::take(2)) v.push_back(i);
+        REQUIRE(v == v_comp);
+        REQUIRE(stack.size() == 3);
+        REQUIRE(stack[2] == 3);
+    }
+}
+
+TEST_CASE("Stack snapshot")
+{
+    char path[] = "/tmp/stacksnapXXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+
+    Stack<int> stack({1, 2, 3, 4, 5}, false);
+    stack.push_bottom(6);
+    stack.save(fd);
+
+    Stack<int> loaded = {9};
+    lseek(fd, 0, SEEK_SET);
+    loaded.load(fd);
+
+    REQUIRE(loaded == stack);
+    REQUIRE(loaded.getDirection() == false);
+    REQUIRE(loaded.size() == 6);
+
+    loaded.push_top(0);
+    REQUIRE(loaded[0] == 0);
+
+    close(fd);
+    std::remove(path);
+}
+
+TEST_CASE("Stack mapped")
+{
+    char path[] = "/tmp/stackmapXXXXXX";
+    close(mkstemp(path));
+    std::remove(path);
+
+    {
+        Stack<long> stack = Stack<long>::mapped(path, 2);
+        REQUIRE(stack.is_mapped());
+
+        for(long i = 0; i < 100; i++)
+            stack.push_top(i);
+        for(long i = 1; i <= 50; i++)
+            stack.push_bottom(-i);
+
+        REQUIRE(stack.size() == 150);
+        REQUIRE(stack[0] == 99);
+        REQUIRE(stack[149] == -50);
+
+        stack.reverse();
+    }
+
+    {
+        Stack<long> stack = Stack<long>::mapped(path);
+        REQUIRE(stack.size() == 150);
+        REQUIRE(stack.getDirection() == false);
+        REQUIRE(stack[0] == -50);
+        REQUIRE(stack[149] == 99);
+
+        REQUIRE(stack.pull_top() == -50);
+        stack.clear();
+        stack.push_top(7);
+        REQUIRE(stack[0] == 7);
+    }
+
+    {
+        Stack<long> stack = Stack<long>::mapped(path);
+        REQUIRE(stack.size() == 1);
+        REQUIRE(stack[0] == 7);
+    }
+
+    REQUIRE_THROWS(Stack<int>::mapped(path));
+    std::remove(path);
+}
+
+TEST_CASE("Stack allocations")
+{
+    Stack<int> stack(16, 16);
+
+    REQUIRE_NO_ALLOC(for(int i = 0; i < 32; i++) stack.push_top(i));
+    REQUIRE_NO_ALLOC(for(int i = 0; i < 16; i++) stack.push_bottom(i));
+    REQUIRE_ALLOCS(1, stack.push_top(32));
+
+    long sum = 0;
+    REQUIRE_NO_ALLOC(for(int i : stack) sum += i);
+    REQUIRE_NO_ALLOC(sum += stack.pull_top() + stack.pull_bottom());
+    REQUIRE_NO_ALLOC(stack.pop_top(); stack.pop_bottom());
+    REQUIRE_NO_ALLOC(sum += stack == stack);
+    REQUIRE(sum != 0);
+}
+
+TEST_CASE("Stack stats")
+{
+    struct Observer : StatsObserver
+    {
+        int resizes = 0;
+        std::size_t bytes = 0;
+        void stackResized(const void *, std::size_t, std::size_t, std::size_t relocated) override { resizes++; bytes += relocated; }
+    } observer;
+
+    ScopedStatsObserver scoped(&observer);
+
+    Stack<int> stack(4);
+    for(int i = 0; i < 5; i++)
+        stack.push_top(i);
+    for(int i = 0; i < 3; i++)
+        stack.pop_top();
+
+    StackStats s = stack.stats();
+    REQUIRE(s.resizes == 1);
+    REQUIRE(s.bytes_relocated == 4 * sizeof(int));
+    REQUIRE(s.peak_size == 5);
+    REQUIRE(s.size == 2);
+    REQUIRE(s.capacity == 16);
+    REQUIRE(s.gap_waste() == 14);
+
+    REQUIRE(observer.resizes == 1);
+    REQUIRE(observer.bytes == 4 * sizeof(int));
+
+}
+
+TEMPLATE_TEST_CASE("Stack bulk operations", "", int, float, short, double, unsigned char, long)
+{
+    Stack<TestType> forward(4), backward(4);
+    backward.reverse();
+
+    for(int i = 0; i < 37; i++)
+    {
+        forward.push_top(TestType(i % 11));
+        backward.push_top(TestType(i % 11));
+    }
+
+    REQUIRE(forward.equals(backward));
+    REQUIRE(forward == backward);
+
+    REQUIRE(forward.count(TestType(3)) == 4);
+    REQUIRE(backward.count(TestType(10)) == 3);
+    REQUIRE(forward.count(TestType(42)) == 0);
+
+    REQUIRE(forward.sum() == TestType(3 * 55 + 1 + 2 + 3));
+    REQUIRE(forward.min() == TestType(0));
+    REQUIRE(backward.max() == TestType(10));
+
+    REQUIRE(forward.find(TestType(5)) == forward.begin() + (36 - 27));
+    REQUIRE(backward.find(TestType(5)) == backward.begin() + (36 - 27));
+    REQUIRE(*forward.find(TestType(5)) == TestType(5));
+    REQUIRE(forward.find(TestType(42)) == forward.end());
+    REQUIRE(backward.find(TestType(42)) == backward.end());
+
+    backward.push_bottom(TestType(1));
+    REQUIRE(forward != backward);
+    backward.pop_bottom();
+    *backward.rbegin() = TestType(9);
+    REQUIRE(forward != backward);
+
+    forward.fill(TestType(7));
+    REQUIRE(forward.count(TestType(7)) == 37);
+    REQUIRE(forward.min() == TestType(7));
+    REQUIRE(forward.max() == TestType(7));
+
+    Stack<TestType> empty;
+    REQUIRE_THROWS(empty.min());
+    REQUIRE(empty.sum() == TestType(0));
+}
+
+TEMPLATE_TEST_CASE("Stack min and max skip NaN", "", float, double)
+{
+    const TestType nan = std::numeric_limits<TestType>::quiet_NaN();
+
+    for(int at : { 0, 1, 5, 20, 36 })
+    {
+        Stack<TestType> s;
+        for(int i = 0; i < 37; i++)
+            s.push_top(i == at ? nan : i == 29 ? TestType(-5) : i == 33 ? TestType(50) : TestType(i % 11));
+
+        REQUIRE(s.min() == TestType(-5));
+        REQUIRE(s.max() == TestType(50));
+    }
+
+    Stack<TestType> s;
+    s.push_top(nan);
+    s.push_top(TestType(3));
+    for(int i = 0; i < 40; i++)
+        s.push_top(i == 9 ? TestType(-1) : nan);
+
+    REQUIRE(s.min() == TestType(-1));
+    REQUIRE(s.max() == TestType(3));
+
+    s.fill(nan);
+    REQUIRE(std::isnan(s.min()));
+    REQUIRE(std::isnan(s.max()));
+}
+
+TEST_CASE("Stack of owning elements")
+{
+    Stack<std::string> source = { "one", "two", "three" };
+    source.reverse();
+
+    SECTION("Copy assignment keeps the source and its direction")
+    {
+        Stack<std::string> copy;
+        copy = source;
+        REQUIRE(copy == source);
+        REQUIRE(copy.getDirection() == false);
+        REQUIRE(source[0] == "one");
+        REQUIRE(source[2] == "three");
+
+        copy = copy;
+        REQUIRE(copy.size() == 3);
+    }
+
+    SECTION("Moved-from stacks can be reused and destroyed")
+    {
+        Stack<std::string> moved = std::move(source);
+        REQUIRE(moved.size() == 3);
+        REQUIRE(source.size() == 0);
+
+        for(int i = 0; i < 20; i++)
+            source.push_top(std::to_string(i));
+        REQUIRE(source.size() == 20);
+
+        source = std::move(moved);
+        REQUIRE(source[0] == "one");
+    }
+
+    SECTION("Popped slots release what they own")
+    {
+        std::shared_ptr<int> shared = std::make_shared<int>(1);
+        Stack<std::shared_ptr<int>> pointers;
+        pointers.push_top(shared);
+        pointers.push_bottom(shared);
+        REQUIRE(shared.use_count() == 3);
+
+        pointers.pop_top();
+        pointers.pop_bottom();
+        REQUIRE(shared.use_count() == 1);
+
+        pointers.push_top(shared);
+        pointers.clear();
+        REQUIRE(shared.use_count() == 1);
+    }
+}
+
+namespace
+{
+    struct ThrowingCopy
+    {
+        static inline bool fail = false;
+        int value = 0;
+
+        ThrowingCopy() = default;
+        ThrowingCopy(int value) : value(value) { }
+        ThrowingCopy(const ThrowingCopy &) = default;
+
+        ThrowingCopy &operator=(const ThrowingCopy &other)
+        {
+            if(fail)
+                throw "copy failed";
+            value = other.value;
+            return *this;
+        }
+    };
+}
+
+TEST_CASE("Stack pushes that throw leave the stack unchanged")
+{
+    Stack<ThrowingCopy> stack(4);
+    stack.push_top(1);
+    stack.push_bottom(2);
+
+    ThrowingCopy::fail = true;
+    REQUIRE_THROWS(stack.push_top(3));
+    REQUIRE_THROWS(stack.push_bottom(4));
+    ThrowingCopy::fail = false;
+
+    REQUIRE(stack.size() == 2);
+    REQUIRE(stack[0].value == 1);
+    REQUIRE(stack[1].value == 2);
+}
+
+TEST_CASE("Stack standard algorithms")
+{
+    Stack<int> stack = { 4, 2, 5, 1, 3 };
+
+    std::ranges::sort(stack.begin(), stack.end());
+    REQUIRE(stack.pull_top() == 1);
+    REQUIRE(stack.pull_bottom() == 5);
+
+    std::vector<int> copy(stack.size());
+    std::copy(stack.buffer_begin(), stack.buffer_end(), copy.begin());
+    REQUIRE(copy == std::vector<int>{ 4, 3, 2 });
+
+    stack.reverse();
+    REQUIRE(*stack.buffer_begin() == 4);
+    REQUIRE(*stack.begin() == 4);
+}
+
+TEST_CASE("Stack used as a queue does not grow")
+{
+    Stack<int> queue(8);
+    for(int i = 0; i < 4; i++)
+        queue.push_top(i);
+
+    std::size_t capacity = queue.stats().capacity;
+    REQUIRE_NO_ALLOC(for(int i = 0; i < 1000; i++) { queue.push_top(i); queue.pop_bottom(); });
+    REQUIRE_NO_ALLOC(for(int i = 0; i < 1000; i++) { queue.push_bottom(i); queue.pop_top(); });
+    REQUIRE(queue.stats().capacity == capacity);
+    REQUIRE(queue.size() == 4);
+    REQUIRE(queue.pull_top() == 996);
+}
+
+TEST_CASE("Stack growth from tiny capacities")
+{
+    Stack<int> one(1);
+    one.push_bottom(5);
+    one.push_bottom(6);
+    REQUIRE(one.pull_top() == 5);
+    REQUIRE(one.pull_top() == 6);
+
+    Stack<int> two(2);
+    two.push_top(1);
+    two.push_bottom(2);
+    two.push_top(3);
+    REQUIRE(two.size() == 3);
+    REQUIRE(two.pull_bottom() == 2);
+    REQUIRE(two.pull_bottom() == 1);
+    REQUIRE(two.pull_bottom() == 3);
+
+    Stack<int> grown(1);
+    for(int i = 0; i < 100; i++)
+        i % 2 ? grown.push_top(i) : grown.push_bottom(i);
+    REQUIRE(grown.size() == 100);
+    REQUIRE(grown[0] == 99);
+    REQUIRE(grown[99] == 98);
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+
+#include "types/staticstack.h"
+#include "alloccounter.h"
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace Types;
+
+static_assert(std::is_trivially_copyable_v<StaticStack<int, 16>>);
+static_assert(std::random_access_iterator<StaticStack<int, 4>::Iterator>);
+static_assert(std::random_access_iterator<StaticStack<int, 4>::ConstIterator>);
+
+constexpr int evaluate(const char *rpn)
+{
+    StaticStack<int, 8> stack;
+    for(; *rpn; rpn++)
+    {
+        if(*rpn >= '0' && *rpn <= '9')
+            stack.push_top(*rpn - '0');
+        else
+        {
+            int b = stack.pull_top(), a = stack.pull_top();
+            stack.push_top(*rpn == '+' ? a + b : *rpn == '-' ? a - b : a * b);
+        }
+    }
+    return stack.pull_top();
+}
+
+static_assert(evaluate("34+2*71-+") == 20);
+
+constexpr StaticStack<int, 4> compile_time_stack()
+{
+    StaticStack<int, 4> stack = { 1, 2, 3 };
+    stack.push_bottom(0);
+    stack.reverse();
+    return stack;
+}
+
+static_assert(compile_time_stack()[0] == 0);
+static_assert(compile_time_stack().full());
+
+TEST_CASE("StaticStack push and pull at both ends")
+{
+    StaticStack<std::string, 4> stack;
+
+    REQUIRE(stack.push_top("b"));
+    REQUIRE(stack.push_bottom("a"));
+    REQUIRE(stack.push_top("c"));
+    REQUIRE(stack.size() == 3);
+
+    REQUIRE(stack[0] == "c");
+    REQUIRE(stack[2] == "a");
+    REQUIRE_THROWS(stack[3]);
+
+    stack.reverse();
+    REQUIRE(stack.pull_top() == "a");
+    REQUIRE(stack.pull_bottom() == "c");
+
+    for(int i = 0; i < 100; i++)
+    {
+        stack.push_top(std::to_string(i));
+        stack.pop_bottom();
+    }
+    REQUIRE(stack.size() == 1);
+    REQUIRE(stack[0] == "99");
+
+    stack.clear();
+    REQUIRE(stack.empty());
+    REQUIRE(stack.pull_top() == "");
+}
+
+TEST_CASE("StaticStack overflow policies")
+{
+    StaticStack<int, 2> throwing = { 1, 2 };
+    REQUIRE_THROWS(throwing.push_top(3));
+    REQUIRE(throwing.size() == 2);
+
+    StaticStack<int, 2, ErrorOnOverflow> error = { 1, 2 };
+    REQUIRE(!error.push_top(3));
+    REQUIRE(!error.push_bottom(3));
+    REQUIRE(error[0] == 2);
+}
+
+TEST_CASE("StaticStack iteration and copies")
+{
+    StaticStack<int, 8> stack = { 1, 2, 3, 4 };
+
+    REQUIRE(std::vector<int>(stack.begin(), stack.end()) == std::vector<int>{ 4, 3, 2, 1 });
+
+    for(int &x : stack)
+        x *= 10;
+    REQUIRE(stack[3] == 10);
+
+    StaticStack<int, 8> copy;
+    REQUIRE_NO_ALLOC(copy = stack);
+    REQUIRE(copy == stack);
+
+    copy.pop_top();
+    REQUIRE(copy != stack);
+}
+
+TEST_CASE("StaticStack pops release owned resources")
+{
+    std::shared_ptr<int> shared = std::make_shared<int>(1);
+    StaticStack<std::shared_ptr<int>, 4> stack;
+
+    stack.push_top(shared);
+    stack.push_bottom(shared);
+    stack.push_top(shared);
+    REQUIRE(shared.use_count() == 4);
+
+    stack.pop_top();
+    stack.pop_bottom();
+    REQUIRE(shared.use_count() == 2);
+
+    stack.clear();
+    REQUIRE(shared.use_count() == 1);
+    REQUIRE(stack.empty());
+
+    stack.push_top(shared);
+    REQUIRE(stack.pull_top() == shared);
+    REQUIRE(shared.use_count() == 1);
+}
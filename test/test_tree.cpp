@@ -2,6 +2,12 @@
 
 #include "types/tree.h"
 
+#include "alloccounter.h"
+
+#include <algorithm>
+#include <ranges>
+#include <set>
+#include <string_view>
 #include <vector>
 
 using namespace Types;
@@ -148,3 +154,513 @@ TEST_CASE("Tree copy and move")
     REQUIRE(t1.begin().getPtr() == nullptr);
 
 }
+
+TEST_CASE("Tree emplace and batch insertion")
+{
+    Tree<std::string, int> t("root");
+
+    SECTION("Emplace")
+    {
+        Tree<std::string, int> *c = t.emplaceChild(3, 'a');
+        REQUIRE(**c == "aaa");
+        REQUIRE(c->getParent() == &t);
+
+        Tree<std::string, int> *l = t.emplaceLabeledChild(100, 2, 'b');
+        REQUIRE(**l == "bb");
+        REQUIRE(t[100] == l);
+        REQUIRE(l->getLabel() == 100);
+    }
+
+    SECTION("Set existing label")
+    {
+        t.setChild("a", 100);
+        t.addChild("b");
+        Tree<std::string, int> *first = t[100];
+        first->addChild("grandchild");
+
+        t.setChild("c", 100);
+        REQUIRE(t[100] == first);
+        REQUIRE(**t[100] == "c");
+        REQUIRE(t[100]->begin().getPtr() == nullptr);
+
+        std::vector<std::string> v, v_comp = {"c", "b"};
+        for(auto &c : t) v.push_back(*c);
+        REQUIRE(v == v_comp);
+    }
+
+    SECTION("Add children")
+    {
+        std::vector<std::string> v_comp = {"x", "y", "z"};
+        t.addChildren(v_comp);
+        t.addChildren({"w"});
+        v_comp.push_back("w");
+
+        std::vector<std::string> v;
+        for(auto &c : t) v.push_back(*c);
+        REQUIRE(v == v_comp);
+    }
+}
+
+TEST_CASE("Tree parent links and first child deletion")
+{
+    Tree<int, int> t1(1);
+    t1.setChild(2, 100);
+    t1.addChild(3);
+
+    Tree<int, int> t2 = t1;
+    REQUIRE(t2[100]->getParent() == &t2);
+
+    Tree<int, int> t3(0);
+    t3 = std::move(t2);
+    REQUIRE(t3[100]->getParent() == &t3);
+
+    delete t3[100];
+    REQUIRE(**t3.begin() == 3);
+    REQUIRE(t3[100] == nullptr);
+
+    delete t3.begin().getPtr();
+    REQUIRE(t3.begin().getPtr() == nullptr);
+    REQUIRE(t3.rbegin().getPtr() == nullptr);
+}
+
+TEST_CASE("Tree random access children")
+{
+    Tree<int, int> t(0);
+    t.addChildren({5, 1, 4});
+    t.setChild(3, 100);
+
+    REQUIRE(t.childCount() == 4);
+    REQUIRE(**t.child(2) == 4);
+    REQUIRE(t.child(4) == nullptr);
+
+    t.setChildIndexing(true);
+    t.addChild(2);
+
+    REQUIRE(t.childCount() == 5);
+    REQUIRE(**t.child(4) == 2);
+    REQUIRE(t.childrenEnd() - t.childrenBegin() == 5);
+    REQUIRE(*t.childrenBegin()[3] == 3);
+
+    SECTION("Removal")
+    {
+        delete t[100];
+        delete t.child(0);
+
+        REQUIRE(t.childCount() == 3);
+        REQUIRE(**t.child(0) == 1);
+        REQUIRE(**t.child(2) == 2);
+
+        delete t.child(1);
+        t.addChild(7);
+        delete t.child(0);
+        REQUIRE(t.childCount() == 2);
+        REQUIRE(**t.child(1) == 7);
+        REQUIRE(&t.childrenBegin()[0] == t.child(0));
+
+        t.reorderChildren([](auto b, auto e) { std::reverse(b, e); });
+        delete t.child(0);
+        REQUIRE(t.childCount() == 1);
+        REQUIRE(**t.child(0) == 2);
+        REQUIRE(&*t.begin() == t.child(0));
+    }
+
+    SECTION("Moving indexed children")
+    {
+        Tree<int, int> other(0);
+        other.setChildIndexing(true);
+        other = std::move(t);
+
+        REQUIRE(t.childCount() == 0);
+        REQUIRE(other.childCount() == 5);
+        REQUIRE(**other.child(4) == 2);
+
+        delete other.child(1);
+        REQUIRE(**other.child(1) == 4);
+
+        Tree<int, int> plain(0);
+        plain = std::move(other);
+        REQUIRE(plain.memoryBreakdown().extras == 0);
+        REQUIRE(**plain.child(3) == 2);
+    }
+
+    SECTION("Reorder")
+    {
+        t.reorderChildren([](auto b, auto e) { std::sort(b, e, [](Tree<int, int> *x, Tree<int, int> *y) { return **x < **y; }); });
+
+        std::vector<int> v, v_comp = {1, 2, 3, 4, 5};
+        for(auto &c : t) v.push_back(*c);
+        REQUIRE(v == v_comp);
+        REQUIRE(**t.rbegin() == 5);
+
+        static_assert(std::is_same<decltype(*t.childrenBegin()), const Tree<int, int>&>::value, "children are reordered through reorderChildren() only");
+        auto it = std::lower_bound(t.childrenBegin(), t.childrenEnd(), 3, [](const Tree<int, int> &c, int x) { return *c < x; });
+        REQUIRE(it - t.childrenBegin() == 2);
+        REQUIRE(&*it == t[100]);
+    }
+
+    SECTION("Disable")
+    {
+        t.setChildIndexing(false);
+        REQUIRE(t.childCount() == 5);
+        REQUIRE(**t.child(3) == 3);
+        REQUIRE_THROWS(t.reorderChildren([](auto, auto) { }));
+    }
+}
+
+TEST_CASE("Tree lazy walks")
+{
+    Tree<int, int> t(1);
+    t.addChildren({2, 3});
+    t.child(0)->addChildren({4, 5});
+    t.child(0)->child(1)->addChild(6);
+    t.addChild(7);
+
+    SECTION("Preorder")
+    {
+        std::vector<int> v, v_comp = {1, 2, 4, 5, 6, 3, 7};
+        for(Tree<int, int> &n : t.walkPreorder()) v.push_back(*n);
+        REQUIRE(v == v_comp);
+
+        v.clear(); v_comp = {2, 4, 5, 6};
+        for(Tree<int, int> &n : t.child(0)->walkPreorder()) v.push_back(*n);
+        REQUIRE(v == v_comp);
+    }
+
+    SECTION("Leaves")
+    {
+        std::vector<int> v, v_comp = {4, 6, 3, 7};
+        for(Tree<int, int> &n : t.walkLeaves()) v.push_back(*n);
+        REQUIRE(v == v_comp);
+    }
+
+    SECTION("Ranges")
+    {
+        auto odd = t.walkPreorder()
+                 | std::views::transform([](Tree<int, int> &n) { return *n; })
+                 | std::views::filter([](int i) { return i % 2; })
+                 | std::views::take(2);
+
+        std::vector<int> v, v_comp = {1, 5};
+        for(int i : odd) v.push_back(i);
+        REQUIRE(v == v_comp);
+    }
+}
+
+TEST_CASE("Tree allocations")
+{
+    Tree<int> t(0);
+    std::string a = "a", missing = "a label that does not fit in the small string buffer";
+
+    REQUIRE_ALLOCS(2, t.setChild(1, a));
+    REQUIRE_ALLOCS(1, t.addChild(2));
+    REQUIRE_NO_ALLOC(t.setChild(3, a));
+
+    Tree<int> *found = nullptr;
+    REQUIRE_NO_ALLOC(found = t[a]);
+    REQUIRE(**found == 3);
+    REQUIRE_NO_ALLOC(found = t[missing]);
+    REQUIRE(found == nullptr);
+
+    long sum = 0;
+    REQUIRE_NO_ALLOC(for(Tree<int> &c : t) sum += *c);
+    REQUIRE_NO_ALLOC(for(auto it = t.rbegin(); it != t.rend(); it--) sum += **it);
+    REQUIRE_NO_ALLOC(sum += t.childCount() + (t == t));
+    REQUIRE(sum == 13);
+}
+
+TEST_CASE("Tree stats")
+{
+    struct Observer : StatsObserver
+    {
+        int added = 0, removed = 0;
+        void treeNodeAdded(const void *, const void *) override { added++; }
+        void treeNodeRemoved(const void *) override { removed++; }
+    } observer;
+
+    ScopedStatsObserver scoped(&observer);
+
+    {
+        Tree<int, int> t(0);
+        t.setChild(1, 10);
+        t.setChild(2, 20);
+        t.addChild(3);
+        t[10]->addChildren({4, 5});
+        t[10]->child(0)->addChild(6);
+
+        TreeStats s = t.stats();
+        REQUIRE(s.nodes == 7);
+        REQUIRE(s.depth == 3);
+        REQUIRE(s.fanout == std::vector<std::size_t>{4, 1, 1, 1});
+        REQUIRE(s.map_entries == 2);
+        REQUIRE(s.map_bytes > 2 * sizeof(int));
+
+        REQUIRE(t[10]->stats().nodes == 4);
+        REQUIRE(observer.added == 6);
+    }
+
+    REQUIRE(observer.removed == 7);
+}
+
+TEST_CASE("Tree memory usage")
+{
+    Tree<std::string> t("root");
+    std::string long_label(100, 'l'), long_contents(200, 'c');
+
+    t.setChild("a", "x");
+    t.setChild(long_contents, long_label);
+    t.addChild("y");
+
+    TreeMemory m = t.memoryBreakdown();
+    REQUIRE(m.nodes == 4 * sizeof(Tree<std::string>));
+    REQUIRE(m.children_maps == 2 * mapNodeBytes<std::pair<const std::string, Tree<std::string>*>>());
+    REQUIRE(m.labels == 2 * (long_label.capacity() + 1));
+    REQUIRE(m.contents == long_contents.capacity() + 1);
+    REQUIRE(m.child_arrays == 0);
+    REQUIRE(m.extras == 0);
+    REQUIRE(m.label_index == 0);
+    REQUIRE(t.memoryUsage() == m.total());
+
+    t.setLabelIndexing(true);
+    TreeMemory indexed = t.memoryBreakdown();
+    REQUIRE(indexed.extras > 0);
+    REQUIRE(indexed.label_index > 2 * mapNodeBytes<std::pair<const std::string, std::vector<void*>>>());
+    REQUIRE(t["x"]->memoryBreakdown().label_index == 0);
+    t.setLabelIndexing(false);
+    REQUIRE(t.memoryUsage() == m.total());
+
+    t.setChildIndexing(true);
+    REQUIRE(t.memoryBreakdown().child_arrays >= 3 * sizeof(void*));
+    REQUIRE(t.memoryBreakdown().extras > 0);
+
+    TreeMemory a = t.memoryBreakdown(true);
+    REQUIRE(a.nodes > m.nodes);
+    REQUIRE(a.total() > t.memoryUsage());
+    REQUIRE(a.contents == allocatedBytes(long_contents.capacity() + 1));
+
+    REQUIRE(t["x"]->memoryBreakdown().nodes == sizeof(Tree<std::string>));
+    REQUIRE(t["x"]->memoryBreakdown().extras > 0);
+
+    t.setChildIndexing(false);
+    REQUIRE(t.memoryUsage() == m.total());
+}
+
+TEST_CASE("Tree subtree aggregates")
+{
+    using Agg = Aggregates<SubtreeSize, SubtreeSum<long>, SubtreeHeight>;
+    using Node = Tree<int, std::string, Agg>;
+
+    REQUIRE(sizeof(Tree<int>) == sizeof(Tree<int, std::string, NoAggregate>));
+
+    Node root(1);
+    root.setChild(2, "a");
+    root.setChild(3, "b");
+    Node *a = root["a"];
+    a->setChild(4, "x");
+    a->setChild(5, "y");
+    (*a)["y"]->addChild(6);
+
+    REQUIRE(root.aggregate() == Agg::value_type(6, 21, 4));
+    REQUIRE(a->aggregate() == Agg::value_type(4, 17, 3));
+
+    const Node &croot = root;
+    REQUIRE_NO_ALLOC(croot.aggregate());
+
+    SECTION("Contents changes")
+    {
+        (*a)["x"]->setContents(40);
+        REQUIRE(std::get<1>(root.aggregate()) == 57);
+        REQUIRE(std::get<1>(croot["b"]->aggregate()) == 3);
+
+        (*a)["y"]->modifyContents([](int &v) { v *= 2; });
+        REQUIRE(std::get<1>(root.aggregate()) == 62);
+
+        int sum = 0;
+        for(Node &n : *a)
+            sum += *n + n.getContents();
+        REQUIRE(sum == 2 * (40 + 10));
+        REQUIRE_NO_ALLOC(croot.aggregate());
+    }
+
+    SECTION("Adding and replacing children")
+    {
+        root["b"]->addChild(7);
+        REQUIRE(root.aggregate() == Agg::value_type(7, 28, 4));
+
+        root.setChild(10, "a");
+        REQUIRE(root.aggregate() == Agg::value_type(4, 21, 3));
+    }
+
+    SECTION("Removing children")
+    {
+        delete (*a)["y"];
+        REQUIRE(root.aggregate() == Agg::value_type(4, 10, 3));
+
+        a->clear();
+        REQUIRE(root.aggregate() == Agg::value_type(3, 6, 2));
+    }
+
+    SECTION("Copies and moves")
+    {
+        Node copy = root;
+        REQUIRE(copy.aggregate() == root.aggregate());
+
+        Node moved = std::move(*a);
+        REQUIRE(moved.aggregate() == Agg::value_type(4, 17, 3));
+        REQUIRE(root.aggregate() == Agg::value_type(3, 6, 2));
+    }
+}
+
+TEST_CASE("Tree aggregates of a deep and wide tree")
+{
+    Tree<int, std::string, SubtreeSize> root(0);
+
+    Tree<int, std::string, SubtreeSize> *node = &root;
+    for(int i = 0; i < 5000; i++)
+        node = node->emplaceChild(i);
+    for(int i = 0; i < 100000; i++)
+        root.emplaceChild(i);
+
+    REQUIRE(root.aggregate() == 105001);
+
+    node->emplaceChild(0);
+    REQUIRE(root.aggregate() == 105002);
+    REQUIRE(root.child(0)->aggregate() == 5001);
+}
+
+TEST_CASE("Deep trees are cleared without recursion")
+{
+    Tree<int> root(0);
+    root.setLabelIndexing(true);
+
+    Tree<int> *node = &root;
+    for(int i = 0; i < 200000; i++)
+        node = node->emplaceLabeledChild(std::to_string(i % 3), i);
+
+    REQUIRE(root.labeledNodes("1").size() == 66667);
+
+    auto watch = root.watchStructure();
+    std::size_t version = watch.version();
+    root.child(0)->clear();
+    REQUIRE(watch.version() != version);
+    REQUIRE(root.child(0)->childCount() == 0);
+    REQUIRE(root.labeledNodes("0").size() == 1);
+    REQUIRE(root.labeledNodes("1").empty());
+
+    node = &root;
+    for(int i = 0; i < 200000; i++)
+        node = node->emplaceChild(i);
+}
+
+TEST_CASE("LabelPattern matching")
+{
+    REQUIRE(LabelPattern::glob("conf*", "config"));
+    REQUIRE(LabelPattern::glob("*.y?ml", "app.yaml"));
+    REQUIRE(LabelPattern::glob("*", ""));
+    REQUIRE_FALSE(LabelPattern::glob("conf?", "conf"));
+    REQUIRE_FALSE(LabelPattern::glob("*b", "abc"));
+
+    LabelPattern p("/services//**/**/config/");
+    REQUIRE(p.size() == 3);
+    REQUIRE(p[0].kind == LabelPattern::LITERAL);
+    REQUIRE(p[1].kind == LabelPattern::RECURSIVE);
+    REQUIRE(p.recursiveCount() == 1);
+
+    REQUIRE(p.matchPath(0, 3, { "services", "config" }));
+    REQUIRE(p.matchPath(0, 3, { "services", "a", "b", "config" }));
+    REQUIRE_FALSE(p.matchPath(0, 3, { "services", "a" }));
+    REQUIRE_FALSE(p.matchPath(0, 3, { "config" }));
+}
+
+namespace
+{
+    template <typename Node>
+    std::set<Node*> matches(const Node &root, std::string_view pattern)
+    {
+        std::vector<Node*> found = root.query(pattern);
+        std::set<Node*> unique(found.begin(), found.end());
+        REQUIRE(unique.size() == found.size());
+        return unique;
+    }
+}
+
+TEST_CASE("Tree label queries")
+{
+    Tree<int> root(0);
+    root.setChild(1, "services");
+    Tree<int> *services = root["services"];
+    services->setChild(2, "web");
+    services->setChild(3, "db");
+    services->setChild(4, "cache");
+    (*services)["web"]->setChild(5, "config");
+    (*services)["db"]->setChild(6, "config");
+    (*(*services)["db"])["config"]->setChild(7, "timeout");
+    (*services)["web"]->addChild(8);
+    root.setChild(9, "timeout");
+
+    Tree<int> *web_config = (*(*services)["web"])["config"];
+    Tree<int> *db_config = (*(*services)["db"])["config"];
+    Tree<int> *db_timeout = (*db_config)["timeout"];
+
+    bool indexed = GENERATE(false, true);
+    root.setLabelIndexing(indexed);
+    REQUIRE(services->getLabelIndexing() == indexed);
+
+    REQUIRE(matches(root, "services/*/config") == std::set<Tree<int>*>{ web_config, db_config });
+    REQUIRE(matches(root, "**/timeout") == std::set<Tree<int>*>{ root["timeout"], db_timeout });
+    REQUIRE(matches(root, "services/**/timeout") == std::set<Tree<int>*>{ db_timeout });
+    REQUIRE(matches(root, "**/config/**") == std::set<Tree<int>*>{ web_config, db_config, db_timeout });
+    REQUIRE(matches(root, "services/c*") == std::set<Tree<int>*>{ (*services)["cache"] });
+    REQUIRE(matches(root, "services/??") == std::set<Tree<int>*>{ (*services)["db"] });
+    REQUIRE(matches(root, "") == std::set<Tree<int>*>{ &root });
+    REQUIRE(matches(root, "**/missing").empty());
+    REQUIRE(matches(root, "services/*/*/*").size() == 1);
+    REQUIRE(matches(root, "**").size() == 9);
+    REQUIRE(matches(*services, "**/timeout") == std::set<Tree<int>*>{ db_timeout });
+    REQUIRE(matches(*services, "services/**").empty());
+
+    if(!indexed)
+    {
+        REQUIRE_THROWS_WITH(root.labeledNodes("config"), "Tree label indexing is disabled");
+        return;
+    }
+
+    REQUIRE(root.labeledNodes("config").size() == 2);
+    REQUIRE_THROWS_WITH(services->setLabelIndexing(false), "Tree label indexing can only be set on the root");
+
+    SECTION("setChild and destruction update the index")
+    {
+        (*services)["cache"]->setChild(10, "config");
+        REQUIRE(matches(root, "services/*/config").size() == 3);
+
+        delete (*services)["db"];
+        REQUIRE(matches(root, "services/*/config").size() == 2);
+        REQUIRE(matches(root, "**/timeout") == std::set<Tree<int>*>{ root["timeout"] });
+        REQUIRE(root.labeledNodes("timeout").size() == 1);
+
+        services->setChild(11, "web");
+        REQUIRE(matches(root, "**/config").size() == 1);
+        REQUIRE(root.labeledNodes("config").size() == 1);
+    }
+
+    SECTION("Moved subtrees leave the index")
+    {
+        Tree<int> moved = std::move(*services);
+        REQUIRE(matches(root, "**/config").empty());
+        REQUIRE(root.labeledNodes("web").empty());
+        REQUIRE_FALSE(moved.getLabelIndexing());
+        REQUIRE(matches(moved, "*/config").size() == 2);
+
+        Tree<int> copy(0);
+        copy.setLabelIndexing(true);
+        copy = moved;
+        REQUIRE(copy.labeledNodes("config").size() == 2);
+        REQUIRE(matches(copy, "db/config/timeout").size() == 1);
+    }
+
+    SECTION("Disabling keeps the queries working")
+    {
+        root.setLabelIndexing(false);
+        REQUIRE(matches(root, "**/timeout").size() == 2);
+        REQUIRE_FALSE(db_timeout->getLabelIndexing());
+    }
+}
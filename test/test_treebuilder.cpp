@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include "types/treebuilder.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Types;
+
+TEST_CASE("Tree builder events")
+{
+    Tree<int> t(0);
+    TreeBuilder<int> builder(t);
+
+    builder.enter("a");
+    builder.value(1);
+    builder.enter("b");
+    builder.value(2);
+    REQUIRE(builder.depth() == 2);
+    builder.leave();
+    builder.enter();
+    builder.value(3);
+    builder.leave();
+    builder.leave();
+    builder.enter("c");
+    builder.leave();
+
+    REQUIRE(builder.depth() == 0);
+    REQUIRE(&builder.current() == &t);
+    REQUIRE_THROWS(builder.leave());
+
+    REQUIRE(**t["a"] == 1);
+    REQUIRE(**(*t["a"])["b"] == 2);
+    REQUIRE(**t["a"]->child(1) == 3);
+    REQUIRE(**t["c"] == 0);
+    REQUIRE(t.child(1) == t["c"]);
+
+
+    builder.enter("d");
+    builder.enter("e");
+    builder.leave();
+    REQUIRE_THROWS_WITH(builder.enter("e"), "TreeBuilder entered a duplicate label");
+    REQUIRE(builder.depth() == 1);
+    builder.leave();
+
+    REQUIRE_THROWS(builder.enter("a"));
+    REQUIRE(builder.depth() == 0);
+    REQUIRE(**(*t["a"])["b"] == 2);
+    REQUIRE(t["a"]->childCount() == 2);
+    REQUIRE(t.childCount() == 3);
+}
+
+TEST_CASE("Indented tree reader")
+{
+    std::string text =
+        "services\n"
+        "  web: 80\n"
+        "    timeout: 30\n"
+        "  db: 5432\n"
+        "\n"
+        "limits: 7\r\n"
+        "  depth: 12";
+
+    Tree<int> t(0);
+    TreeBuilder<int> builder(t);
+    IndentedTreeReader reader(builder, [](std::string_view v) { return std::stoi(std::string(v)); });
+
+    SECTION("Whole input")
+    {
+        reader.feed(text);
+    }
+
+    SECTION("Small chunks")
+    {
+        for(std::size_t i = 0; i < text.size(); i += 3)
+            reader.feed(std::string_view(text).substr(i, 3));
+    }
+
+    reader.finish();
+    REQUIRE(builder.depth() == 0);
+
+    std::vector<std::string> labels, labels_comp = {"services", "limits"};
+    for(auto &c : t) labels.push_back(c.getLabel());
+    REQUIRE(labels == labels_comp);
+
+    REQUIRE(**(*t["services"])["web"] == 80);
+    REQUIRE(**(*(*t["services"])["web"])["timeout"] == 30);
+    REQUIRE(**(*t["services"])["db"] == 5432);
+    REQUIRE(**t["limits"] == 7);
+    REQUIRE(**(*t["limits"])["depth"] == 12);
+    REQUIRE(t["services"]->childCount() == 2);
+
+
+    IndentedTreeReader repeated(builder, [](std::string_view v) { return std::stoi(std::string(v)); });
+    REQUIRE_THROWS(repeated.feed("limits: 8\n"));
+    REQUIRE(**(*t["limits"])["depth"] == 12);
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch.hpp>
+
+#include "types/treefile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Types;
+
+TEST_CASE("Tree file save and load")
+{
+    struct Point { int x; double y; };
+
+    Tree<Point> t(Point{0, 0.5});
+    t.setChild(Point{1, 1.5}, "services");
+    t.addChild(Point{2, 2.5});
+    t["services"]->setChild(Point{3, 3.5}, "web");
+    t["services"]->setChild(Point{4, 4.5}, "db");
+    t["services"]->setChild(Point{5, 5.5}, "cache");
+    t["services"]->child(1)->setChild(Point{6, 6.5}, "config");
+
+    char path[] = "/tmp/treefileXXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    TreeFile<Point>::save(t, fd);
+    close(fd);
+
+    {
+        TreeFile<Point> file(path);
+        auto root = file.root();
+
+        REQUIRE(file.size() == 7);
+        REQUIRE(root.getContents().x == 0);
+        REQUIRE(!root.isLabeled());
+        REQUIRE(!root.getParent());
+        REQUIRE(root.childCount() == 2);
+
+        auto services = root["services"];
+        REQUIRE(services);
+        REQUIRE(services.getLabel() == "services");
+        REQUIRE((*services).y == 1.5);
+        REQUIRE(services.getParent() == root);
+        REQUIRE(!root.child(1).isLabeled());
+        REQUIRE((*root.child(1)).x == 2);
+        REQUIRE(!root["missing"]);
+        REQUIRE(!root.child(2));
+
+        std::vector<std::string> labels, labels_comp = {"web", "db", "cache"};
+        for(auto c : services) labels.push_back(std::string(c.getLabel()));
+        REQUIRE(labels == labels_comp);
+
+        REQUIRE((*services["db"]).x == 4);
+        REQUIRE((*services["web"]).x == 3);
+        REQUIRE((*services["cache"]).x == 5);
+        REQUIRE((*services["db"]["config"]).x == 6);
+        REQUIRE(services.end() - services.begin() == 3);
+    }
+
+    SECTION("Sections outside the file are rejected")
+    {
+        fd = open(path, O_WRONLY);
+        std::uint64_t node_count = std::uint64_t(1) << 60;
+        REQUIRE(pwrite(fd, &node_count, sizeof(node_count), 16) == sizeof(node_count));
+        close(fd);
+
+        REQUIRE_THROWS_WITH(TreeFile<Point>(path), "TreeFile has an invalid header");
+    }
+
+    SECTION("Corrupt records are rejected when read")
+    {
+        // records start right after the 72 byte header, each is 56 bytes
+        auto corrupt = [&](std::uint64_t node, std::size_t field, std::uint64_t value) {
+            fd = open(path, O_WRONLY);
+            REQUIRE(pwrite(fd, &value, sizeof(value), off_t(72 + node * 56 + field)) == sizeof(value));
+            close(fd);
+        };
+
+        SECTION("Children outside the file")
+        {
+            corrupt(0, 8, std::uint64_t(1) << 62);
+            TreeFile<Point> file(path);
+            REQUIRE_THROWS_WITH(file.root().child(0), "TreeFile record is corrupt");
+            REQUIRE_THROWS_WITH(file.root().begin(), "TreeFile record is corrupt");
+        }
+
+        SECTION("Label outside the string table")
+        {
+            corrupt(1, 40, 1000);
+            TreeFile<Point> file(path);
+            REQUIRE((*file.root().child(1)).x == 2);
+            REQUIRE_THROWS_WITH(file.root()["services"], "TreeFile record is corrupt");
+        }
+
+        SECTION("Parent after its child")
+        {
+            corrupt(3, 0, 5);
+            TreeFile<Point> file(path);
+            REQUIRE_THROWS_WITH(file.root().child(0).child(0).getParent(), "TreeFile record is corrupt");
+        }
+    }
+
+    SECTION("Corrupt index entries are rejected")
+    {
+        fd = open(path, O_RDWR);
+        std::uint64_t index_offset = 0;
+        REQUIRE(pread(fd, &index_offset, sizeof(index_offset), 40) == sizeof(index_offset));
+        std::uint64_t entry = 1000;
+        REQUIRE(pwrite(fd, &entry, sizeof(entry), off_t(index_offset)) == sizeof(entry));
+        close(fd);
+
+        TreeFile<Point> file(path);
+        REQUIRE_THROWS_WITH(file.root()["services"], "TreeFile record is corrupt");
+    }
+
+    std::remove(path);
+}
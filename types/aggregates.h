@@ -0,0 +1,117 @@
+#ifndef AGGREGATES_H
+#define AGGREGATES_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * Subtree aggregates cached by Tree<T, U, A>. An aggregate A provides
+     *   value_type                                       the cached value
+     *   static value_type identity()                     neutral element of combine
+     *   static value_type combine(a, b)                  associative, folds the children left to right
+     *   static value_type node(contents, children)       value of a node from its contents and its folded children
+     */
+
+    /**
+     * @brief NoAggregate Default of Tree, caches nothing and adds nothing to the nodes
+     */
+    struct NoAggregate { };
+
+    /**
+     * @brief SubtreeSize Number of nodes in the subtree
+     */
+    struct SubtreeSize
+    {
+        using value_type = std::size_t;
+
+        static value_type identity() { return 0; }
+        static value_type combine(value_type a, value_type b) { return a + b; }
+
+        template <typename T>
+        static value_type node(const T &, value_type children) { return children + 1; }
+    };
+
+    /**
+     * @brief SubtreeSum Sum of the contents of the subtree
+     * @tparam V Type to sum in, constructible from the contents
+     */
+    template <typename V>
+    struct SubtreeSum
+    {
+        using value_type = V;
+
+        static value_type identity() { return V(); }
+        static value_type combine(const value_type &a, const value_type &b) { return a + b; }
+
+        template <typename T>
+        static value_type node(const T &contents, const value_type &children) { return children + V(contents); }
+    };
+
+    /**
+     * @brief SubtreeHeight Number of nodes on the longest downward path, 1 for a leaf
+     */
+    struct SubtreeHeight
+    {
+        using value_type = std::size_t;
+
+        static value_type identity() { return 0; }
+        static value_type combine(value_type a, value_type b) { return a < b ? b : a; }
+
+        template <typename T>
+        static value_type node(const T &, value_type children) { return children + 1; }
+    };
+
+    /**
+     * @brief Aggregates Several aggregates cached together, the value is a tuple of theirs
+     */
+    template <typename... A>
+    struct Aggregates
+    {
+        using value_type = std::tuple<typename A::value_type...>;
+
+        static value_type identity() { return value_type(A::identity()...); }
+
+        static value_type combine(const value_type &a, const value_type &b)
+        {
+            return combine(a, b, std::index_sequence_for<A...>());
+        }
+
+        template <typename T>
+        static value_type node(const T &contents, const value_type &children)
+        {
+            return node(contents, children, std::index_sequence_for<A...>());
+        }
+
+    private:
+        template <std::size_t... I>
+        static value_type combine(const value_type &a, const value_type &b, std::index_sequence<I...>)
+        {
+            return value_type(A::combine(std::get<I>(a), std::get<I>(b))...);
+        }
+
+        template <typename T, std::size_t... I>
+        static value_type node(const T &contents, const value_type &children, std::index_sequence<I...>)
+        {
+            return value_type(A::node(contents, std::get<I>(children))...);
+        }
+    };
+
+    /**
+     * @brief AggregateCache Cached value of a Tree node, empty for NoAggregate
+     * A dirty node has only dirty ancestors, so marking stops at the first node that is already dirty.
+     */
+    template <typename A>
+    struct AggregateCache
+    {
+        mutable typename A::value_type aggregate_value = A::identity();
+        mutable bool aggregate_dirty = true;
+    };
+
+    template <>
+    struct AggregateCache<NoAggregate> { };
+}
+
+#endif // AGGREGATES_H
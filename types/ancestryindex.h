@@ -0,0 +1,193 @@
+#ifndef ANCESTRYINDEX_H
+#define ANCESTRYINDEX_H
+
+#include "tree.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Types
+{
+    /**
+     * @brief AncestryIndex Euler tour index over a Tree answering depth, ancestor and lowest common ancestor queries in O(1)
+     * The index is built on demand and rebuilt by the next query after a node of the indexed tree has been added, reordered or
+     * destroyed. It watches the structure of that tree only, so other trees can change without invalidating it. Once the root
+     * is destroyed or linked below another node the index stays safe to destroy, but its queries throw.
+     */
+    template <typename T, typename U = std::string>
+    class AncestryIndex
+    {
+        struct Entry
+        {
+            std::size_t depth;
+            std::size_t first; // first position in the Euler tour
+            std::size_t last;  // last position in the Euler tour
+        };
+
+        Tree<T, U> *root;
+        typename Tree<T, U>::StructureWatch watch;
+
+        std::size_t built_version = 0;
+        bool built = false;
+
+        std::unordered_map<const Tree<T, U>*, Entry> entries;
+
+        /**
+         * @brief tour Nodes in Euler tour order, every node is listed on entry and after each of its children
+         */
+        std::vector<Tree<T, U>*> tour;
+        std::vector<std::size_t> tour_depth;
+
+        /**
+         * @brief sparse sparse[k][i] is the position of the shallowest node in tour[i, i + 2^k)
+         */
+        std::vector<std::vector<std::uint32_t>> sparse;
+
+        std::uint32_t shallower(std::uint32_t a, std::uint32_t b) const { return tour_depth[a] <= tour_depth[b] ? a : b; }
+
+        const Entry &entry(const Tree<T, U> *node)
+        {
+            if(!valid())
+                rebuild();
+
+            auto it = entries.find(node);
+            if(it == entries.end())
+                throw "Tree node not in ancestry index";
+
+            return it->second;
+        }
+
+        static std::size_t log2(std::size_t n)
+        {
+            std::size_t l = 0;
+            while(n >>= 1)
+                l++;
+            return l;
+        }
+
+    public:
+        /**
+         * @brief AncestryIndex
+         * @param root Root of the indexed tree, the index is built on the first query
+         */
+        AncestryIndex(Tree<T, U> &root) : root(&root), watch(root.watchStructure()) { }
+
+        /**
+         * @brief valid
+         * @return false if the tree may have changed since the index was built
+         */
+        bool valid() const { return built && watch.alive() && built_version == watch.version(); }
+
+        /**
+         * @brief rebuild Builds the index over the current state of the tree without recursion
+         */
+        void rebuild()
+        {
+            if(!watch.alive())
+                throw "Ancestry index root was destroyed or linked into another tree";
+
+            built_version = watch.version();
+
+            entries.clear();
+            tour.clear();
+            tour_depth.clear();
+
+            using Iterator = typename Tree<T, U>::TreeIterator;
+            std::vector<std::pair<Tree<T, U>*, Iterator>> path;
+
+            entries[root] = Entry{0, 0, 0};
+            tour.push_back(root);
+            tour_depth.push_back(0);
+            path.emplace_back(root, root->begin());
+
+            while(!path.empty())
+            {
+                auto &top = path.back();
+                if(top.second != top.first->end())
+                {
+                    Tree<T, U> *child = &*top.second++;
+                    entries[child] = Entry{path.size(), tour.size(), tour.size()};
+                    tour.push_back(child);
+                    tour_depth.push_back(path.size());
+                    path.emplace_back(child, child->begin());
+                }
+                else
+                {
+                    path.pop_back();
+                    if(!path.empty())
+                    {
+                        entries[path.back().first].last = tour.size();
+                        tour.push_back(path.back().first);
+                        tour_depth.push_back(path.size() - 1);
+                    }
+                }
+            }
+
+            std::size_t levels = log2(tour.size()) + 1;
+            sparse.assign(levels, std::vector<std::uint32_t>());
+
+            sparse[0].resize(tour.size());
+            for(std::size_t i = 0; i < tour.size(); i++)
+                sparse[0][i] = static_cast<std::uint32_t>(i);
+
+            for(std::size_t k = 1; k < levels; k++)
+            {
+                std::size_t half = std::size_t(1) << (k - 1);
+                sparse[k].resize(tour.size() - (half << 1) + 1);
+                for(std::size_t i = 0; i < sparse[k].size(); i++)
+                    sparse[k][i] = shallower(sparse[k - 1][i], sparse[k - 1][i + half]);
+            }
+
+            built = true;
+        }
+
+        /**
+         * @brief size
+         * @return Number of indexed nodes
+         */
+        std::size_t size() { if(!valid()) rebuild(); return entries.size(); }
+
+        /**
+         * @brief depth
+         * @param node
+         * @return Distance of node from the root of the index
+         */
+        std::size_t depth(const Tree<T, U> *node) { return entry(node).depth; }
+
+        /**
+         * @brief isAncestor
+         * @param ancestor
+         * @param node
+         * @return true if ancestor is node or lies on the path from the root to node
+         */
+        bool isAncestor(const Tree<T, U> *ancestor, const Tree<T, U> *node)
+        {
+            const Entry &a = entry(ancestor);
+            const Entry &n = entry(node);
+            return a.first <= n.first && n.last <= a.last;
+        }
+
+        /**
+         * @brief lca Lowest common ancestor
+         * @param a
+         * @param b
+         * @return The deepest node that is an ancestor of both a and b
+         */
+        Tree<T, U> *lca(const Tree<T, U> *a, const Tree<T, U> *b)
+        {
+            std::size_t l = entry(a).first;
+            std::size_t r = entry(b).first;
+            if(l > r)
+                std::swap(l, r);
+
+            std::size_t k = log2(r - l + 1);
+            return tour[shallower(sparse[k][l], sparse[k][r + 1 - (std::size_t(1) << k)])];
+        }
+    };
+}
+
+#endif // ANCESTRYINDEX_H
@@ -0,0 +1,372 @@
+#ifndef BITSTACK_H
+#define BITSTACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * @brief BitStack Double ended stack of flags packed 64 to a word
+     * Works like Stack<bool> with an eighth of the memory; the buffer is not initialized and, like Stack, slides its
+     * contents back instead of growing while at most half of it is in use. Counting and searching go a word at a time.
+     */
+    class BitStack
+    {
+        size_t size_words = 0;
+        uint64_t *words = nullptr;
+
+        size_t bit_begin = 0, bit_end = 0;   // live bits in [bit_begin, bit_end) of the buffer
+
+        /**
+         * @brief direction Direction of the stack; true for forward, false for backward
+         * Forward stacks have their top at the end of the buffer.
+         */
+        bool direction = true;
+
+        static int popcount(uint64_t w)
+        {
+#if defined(__GNUC__)
+            return __builtin_popcountll(w);
+#else
+            int n = 0;
+            for(; w; w &= w - 1) n++;
+            return n;
+#endif
+        }
+
+        static int lowest(uint64_t w)
+        {
+#if defined(__GNUC__)
+            return __builtin_ctzll(w);
+#else
+            int n = 0;
+            for(; !(w & 1); w >>= 1) n++;
+            return n;
+#endif
+        }
+
+        static int highest(uint64_t w)
+        {
+#if defined(__GNUC__)
+            return 63 - __builtin_clzll(w);
+#else
+            int n = 63;
+            for(; !(w >> 63); w <<= 1) n--;
+            return n;
+#endif
+        }
+
+        /**
+         * @brief mask Bits [from, to) of a word, 0 <= from < to <= 64
+         */
+        static uint64_t mask(size_t from, size_t to)
+        {
+            uint64_t high = to == 64 ? ~uint64_t(0) : (uint64_t(1) << to) - 1;
+            return high & ~((uint64_t(1) << from) - 1);
+        }
+
+        bool get(size_t bit) const { return words[bit >> 6] >> (bit & 63) & 1; }
+
+        void set(size_t bit, bool val)
+        {
+            uint64_t m = uint64_t(1) << (bit & 63);
+            words[bit >> 6] = val ? words[bit >> 6] | m : words[bit >> 6] & ~m;
+        }
+
+        size_t position(size_t idx) const { return direction ? bit_end - 1 - idx : bit_begin + idx; }
+
+        void init(size_t size)
+        {
+            size_words = (size + 63) / 64 + 1;
+            if(size_words < 2)
+                size_words = 2;
+
+            words = new uint64_t[size_words];
+            bit_begin = bit_end = size_words / 2 * 64;
+        }
+
+        /**
+         * @brief grow Makes room at both ends, in place while at most half of the buffer is in use
+         * Whole words are moved, so every flag keeps its position within its word.
+         */
+        void grow()
+        {
+            size_t first = bit_begin >> 6;
+            size_t used = ((bit_end + 63) >> 6) - first;
+
+            size_t new_size = size_words;
+            if(2 * used > size_words || size_words - used < 2)
+                new_size = 2 * size_words > used + 2 ? 2 * size_words : used + 2;
+
+            size_t offset = (new_size - used) / 2;
+
+            if(new_size != size_words)
+            {
+                uint64_t *new_words = new uint64_t[new_size];
+                if(used)
+                    memcpy(new_words + offset, words + first, used * sizeof(uint64_t));
+                delete[] words;
+                words = new_words;
+                size_words = new_size;
+            }
+            else if(used)
+                memmove(words + offset, words + first, used * sizeof(uint64_t));
+
+            bit_begin = bit_begin - first * 64 + offset * 64;
+            bit_end   = bit_end   - first * 64 + offset * 64;
+        }
+
+        void push_back_i(bool val)
+        {
+            if(bit_end >= size_words * 64)
+                grow();
+
+            set(bit_end++, val);
+        }
+
+        void push_front_i(bool val)
+        {
+            if(bit_begin == 0)
+                grow();
+
+            set(--bit_begin, val);
+        }
+
+        /**
+         * @brief countRange Number of set bits in [from, to) of the buffer
+         */
+        size_t countRange(size_t from, size_t to) const
+        {
+            if(from >= to)
+                return 0;
+
+            size_t first = from >> 6, last = (to - 1) >> 6;
+            if(first == last)
+                return popcount(words[first] & mask(from & 63, ((to - 1) & 63) + 1));
+
+            size_t n = popcount(words[first] & mask(from & 63, 64));
+            for(size_t w = first + 1; w < last; w++)
+                n += popcount(words[w]);
+            return n + popcount(words[last] & mask(0, ((to - 1) & 63) + 1));
+        }
+
+    public:
+        static constexpr size_t npos = ~size_t(0);
+
+        /**
+         * @brief BitStack
+         * @param size Optional argument to set the initial amount of flags to hold
+         */
+        BitStack(size_t size = 64) { init(size); }
+
+        BitStack(const BitStack &other) { *this = other; }
+        BitStack(BitStack &&other) { *this = std::move(other); }
+
+        ~BitStack() { delete[] words; }
+
+        BitStack &operator=(const BitStack &other)
+        {
+            if(this == &other)
+                return *this;
+
+            uint64_t *new_words = new uint64_t[other.size_words];
+            if(other.size_words)
+                memcpy(new_words, other.words, other.size_words * sizeof(uint64_t));
+
+            delete[] words;
+            words      = new_words;
+            size_words = other.size_words;
+            bit_begin  = other.bit_begin;
+            bit_end    = other.bit_end;
+            direction  = other.direction;
+            return *this;
+        }
+
+        BitStack &operator=(BitStack &&other)
+        {
+            if(this == &other)
+                return *this;
+
+            delete[] words;
+            words      = std::exchange(other.words, nullptr);
+            size_words = std::exchange(other.size_words, 0);
+            bit_begin  = std::exchange(other.bit_begin, 0);
+            bit_end    = std::exchange(other.bit_end, 0);
+            direction  = other.direction;
+            return *this;
+        }
+
+        /**
+         * @brief operator ==
+         * @param other
+         * @return true if both stacks hold the same flags from top to bottom
+         */
+        bool operator ==(const BitStack &other) const
+        {
+            if(size() != other.size())
+                return false;
+
+            for(size_t i = 0; i < size(); i++)
+                if(get(position(i)) != other.get(other.position(i)))
+                    return false;
+            return true;
+        }
+
+        bool operator !=(const BitStack &other) const { return !(*this == other); }
+
+        /**
+         * @brief operator [] Access flag by index from the top
+         * @param idx
+         * @return
+         */
+        bool operator[](size_t idx) const
+        {
+            if(idx >= size())
+                throw "BitStack index out of bounds";
+
+            return get(position(idx));
+        }
+
+        /**
+         * @brief set_at Changes a flag by index from the top
+         * @param idx
+         * @param val
+         */
+        void set_at(size_t idx, bool val)
+        {
+            if(idx >= size())
+                throw "BitStack index out of bounds";
+
+            set(position(idx), val);
+        }
+
+        /**
+         * @brief size
+         * @return Number of flags in the stack
+         */
+        size_t size() const { return bit_end - bit_begin; }
+        bool empty() const { return bit_end == bit_begin; }
+
+        /**
+         * @brief capacity
+         * @return Number of flags the buffer holds
+         */
+        size_t capacity() const { return size_words * 64; }
+
+        /**
+         * @brief count
+         * @param val
+         * @return Number of flags equal to val
+         */
+        size_t count(bool val = true) const
+        {
+            size_t set_bits = countRange(bit_begin, bit_end);
+            return val ? set_bits : size() - set_bits;
+        }
+
+        /**
+         * @brief find Searches from the top a word at a time
+         * @param val
+         * @return Index of the topmost flag equal to val or npos
+         */
+        size_t find(bool val) const
+        {
+            if(empty())
+                return npos;
+
+            uint64_t flip = val ? 0 : ~uint64_t(0);
+            size_t first = bit_begin >> 6, last = (bit_end - 1) >> 6;
+
+            if(direction)
+            {
+                for(size_t w = last + 1; w-- > first;)
+                {
+                    uint64_t bits = (words[w] ^ flip) & mask(w == first ? bit_begin & 63 : 0, w == last ? ((bit_end - 1) & 63) + 1 : 64);
+                    if(bits)
+                        return bit_end - 1 - (w * 64 + highest(bits));
+                }
+            }
+            else
+            {
+                for(size_t w = first; w <= last; w++)
+                {
+                    uint64_t bits = (words[w] ^ flip) & mask(w == first ? bit_begin & 63 : 0, w == last ? ((bit_end - 1) & 63) + 1 : 64);
+                    if(bits)
+                        return w * 64 + lowest(bits) - bit_begin;
+                }
+            }
+
+            return npos;
+        }
+
+        /**
+         * @brief clear Removes all flags and keeps the buffer
+         */
+        void clear() { bit_begin = bit_end = size_words / 2 * 64; }
+
+        /**
+         * @brief push_top Pushes val on the top of the stack
+         * @param val
+         */
+        void push_top(bool val) { direction ? push_back_i(val) : push_front_i(val); }
+
+        /**
+         * @brief push_bottom Pushes val on the bottom of the stack
+         * @param val
+         */
+        void push_bottom(bool val) { direction ? push_front_i(val) : push_back_i(val); }
+
+        void pop_top()    { if(size()) direction ? bit_end-- : bit_begin++; }
+        void pop_bottom() { if(size()) direction ? bit_begin++ : bit_end--; }
+
+        /**
+         * @brief pull_top Returns the flag at the top of the stack and deletes it
+         * @return false for an empty stack
+         */
+        bool pull_top()
+        {
+            if(!size())
+                return false;
+
+            bool val = get(position(0));
+            pop_top();
+            return val;
+        }
+
+        /**
+         * @brief pull_bottom Returns the flag at the bottom of the stack and deletes it
+         * @return false for an empty stack
+         */
+        bool pull_bottom()
+        {
+            if(!size())
+                return false;
+
+            bool val = get(position(size() - 1));
+            pop_bottom();
+            return val;
+        }
+
+        /**
+         * @brief getDirection Get the direction of the stack
+         * @return true for forward, false for backward
+         */
+        bool getDirection() const { return direction; }
+
+        /**
+         * @brief setDirection Set the direction of the stack
+         * @param dir forward, false for backward
+         */
+        void setDirection(bool dir) { direction = dir; }
+
+        /**
+         * @brief reverse Reverses the direction of the stack, which swaps top and bottom
+         */
+        void reverse() { direction = !direction; }
+    };
+}
+
+#endif // BITSTACK_H
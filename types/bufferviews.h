@@ -0,0 +1,256 @@
+#ifndef BUFFERVIEWS_H
+#define BUFFERVIEWS_H
+
+#include "directionaliterator.h"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#if __has_include(<span>) && __cplusplus >= 202002L
+#include <span>
+#endif
+
+namespace Types
+{
+    /**
+     * @brief StridedIterator Random access iterator visiting every stride-th element of contiguous memory
+     * Positions are counted from a base element, so the iterator never points outside the buffer it walks.
+     */
+    template <typename T>
+    class StridedIterator
+    {
+        T* base = nullptr;
+        std::ptrdiff_t step = 1;
+        std::ptrdiff_t idx = 0;
+
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::remove_cv_t<T>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T*;
+        using reference         = T&;
+
+        StridedIterator() = default;
+
+        /**
+         * @brief StridedIterator
+         * @param base Element at position 0
+         * @param step Distance in elements between consecutive positions, negative to walk backward
+         * @param idx Position of the iterator
+         */
+        StridedIterator(T* base, std::ptrdiff_t step, std::ptrdiff_t idx = 0) : base(base), step(step), idx(idx) { }
+
+        StridedIterator<T> &operator ++() { idx++; return *this; }
+        StridedIterator<T> &operator --() { idx--; return *this; }
+
+        StridedIterator<T> operator ++(int) { StridedIterator<T> copy(*this); idx++; return copy; }
+        StridedIterator<T> operator --(int) { StridedIterator<T> copy(*this); idx--; return copy; }
+
+        bool operator ==(const StridedIterator<T> &other) const { return idx == other.idx; }
+        bool operator !=(const StridedIterator<T> &other) const { return idx != other.idx; }
+        bool operator  <(const StridedIterator<T> &other) const { return idx <  other.idx; }
+        bool operator  >(const StridedIterator<T> &other) const { return idx >  other.idx; }
+        bool operator <=(const StridedIterator<T> &other) const { return idx <= other.idx; }
+        bool operator >=(const StridedIterator<T> &other) const { return idx >= other.idx; }
+
+        StridedIterator<T> &operator +=(difference_type add) { idx += add; return *this; }
+        StridedIterator<T> &operator -=(difference_type sub) { idx -= sub; return *this; }
+
+        StridedIterator<T> operator +(difference_type add) const { return StridedIterator<T>(base, step, idx + add); }
+        StridedIterator<T> operator -(difference_type sub) const { return StridedIterator<T>(base, step, idx - sub); }
+
+        friend StridedIterator<T> operator +(difference_type add, const StridedIterator<T> &it) { return it + add; }
+
+        difference_type operator -(const StridedIterator<T> &sub) const { return idx - sub.idx; }
+
+        T &operator[](difference_type i) const { return base[(idx + i) * step]; }
+        T &operator *()  const { return base[idx * step]; }
+        T *operator ->() const { return base + idx * step; }
+
+        /**
+         * @brief getStride
+         * @return Distance in elements between consecutive positions, negative when walking backward
+         */
+        std::ptrdiff_t getStride() const { return step; }
+    };
+
+    /**
+     * @brief StridedView Range of count elements starting at base, step elements apart
+     */
+    template <typename T>
+    class StridedView
+    {
+        T* base;
+        std::ptrdiff_t step;
+        std::size_t count;
+
+    public:
+        StridedView(T* base, std::ptrdiff_t step, std::size_t count) : base(base), step(step), count(count) { }
+
+        /**
+         * @brief StridedView Converts a view of V, e.g. a mutable view into a const one
+         * @param other
+         */
+        template <typename V, typename = std::enable_if_t<std::is_convertible<V*, T*>::value>>
+        StridedView(const StridedView<V> &other) : base(other.base), step(other.step), count(other.count) { }
+
+        template <typename> friend class StridedView;
+
+        StridedIterator<T> begin() const { return StridedIterator<T>(base, step, 0); }
+        StridedIterator<T> end()   const { return StridedIterator<T>(base, step, std::ptrdiff_t(count)); }
+
+        std::size_t size() const { return count; }
+        bool empty() const { return !count; }
+
+        T &operator[](std::size_t i) const { return base[std::ptrdiff_t(i) * step]; }
+    };
+
+    /**
+     * @brief Chunk Contiguous block of a buffer with the order of the container it came from
+     * data() and size() describe the memory of the block; begin(), end() and operator[] follow the container order,
+     * which is the reverse of the memory order for the blocks of a forward Stack.
+     */
+    template <typename T>
+    class Chunk
+    {
+        T* first;
+        std::size_t count;
+        bool direction; // true if the container order is the memory order
+
+    public:
+        Chunk(T* first, std::size_t count, bool direction) : first(first), count(count), direction(direction) { }
+
+        T *data() const { return first; }
+        std::size_t size() const { return count; }
+        bool empty() const { return !count; }
+
+        /**
+         * @brief getDirection
+         * @return true if the elements are in memory order, false if they are in reverse
+         */
+        bool getDirection() const { return direction; }
+
+        T &operator[](std::size_t i) const { return direction ? first[i] : first[count - 1 - i]; }
+
+        DirectionalIterator<T> begin() const { return direction ? DirectionalIterator<T>(first, true)  : DirectionalIterator<T>(first + count - 1, false); }
+        DirectionalIterator<T> end()   const { return direction ? DirectionalIterator<T>(first + count, true) : DirectionalIterator<T>(first - 1, false); }
+
+        ContiguousIterator<T> buffer_begin() const { return ContiguousIterator<T>(first); }
+        ContiguousIterator<T> buffer_end()   const { return ContiguousIterator<T>(first + count); }
+
+#ifdef __cpp_lib_span
+        /**
+         * @brief operator span The block in memory order
+         */
+        operator std::span<T>() const { return std::span<T>(first, count); }
+#endif
+    };
+
+    /**
+     * @brief ChunkView Splits [begin, end) into blocks of n elements, ordered from the front or from the back
+     * Only the last block may be shorter than n.
+     */
+    template <typename T>
+    class ChunkView
+    {
+        T* buffer_begin = nullptr;
+        T* buffer_end = nullptr;
+        std::size_t n = 1;
+        bool direction = true; // true to start at buffer_begin, false to start at buffer_end
+
+    public:
+        class Iterator;
+
+        ChunkView() = default;
+
+        /**
+         * @brief ChunkView
+         * @param buffer_begin
+         * @param buffer_end
+         * @param n Number of elements per block, at least 1
+         * @param direction true to start at buffer_begin, false to start at buffer_end
+         */
+        ChunkView(T* buffer_begin, T* buffer_end, std::size_t n, bool direction) :
+            buffer_begin(buffer_begin), buffer_end(buffer_end), n(n), direction(direction)
+        {
+            if(!n)
+                throw "Chunk size must not be zero";
+        }
+
+        /**
+         * @brief ChunkView Converts a view of V, e.g. a mutable view into a const one
+         * @param other
+         */
+        template <typename V, typename = std::enable_if_t<std::is_convertible<V*, T*>::value>>
+        ChunkView(const ChunkView<V> &other) : buffer_begin(other.buffer_begin), buffer_end(other.buffer_end), n(other.n), direction(other.direction) { }
+
+        template <typename> friend class ChunkView;
+
+        std::size_t size() const { return (std::size_t(buffer_end - buffer_begin) + n - 1) / n; }
+        bool empty() const { return buffer_begin == buffer_end; }
+
+        /**
+         * @brief operator [] Access block by position
+         * @param k Must be less than size()
+         * @return
+         */
+        Chunk<T> operator[](std::size_t k) const
+        {
+            std::size_t total = std::size_t(buffer_end - buffer_begin);
+            std::size_t count = total - k * n < n ? total - k * n : n;
+
+            return direction ? Chunk<T>(buffer_begin + k * n, count, true) : Chunk<T>(buffer_end - k * n - count, count, false);
+        }
+
+        Iterator begin() const { return Iterator(*this, 0); }
+        Iterator end()   const { return Iterator(*this, size()); }
+    };
+
+    template <typename T>
+    class ChunkView<T>::Iterator
+    {
+        ChunkView<T> view;
+        std::size_t idx = 0;
+
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = Chunk<T>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = Chunk<T>;
+
+        Iterator() = default;
+        Iterator(const ChunkView<T> &view, std::size_t idx) : view(view), idx(idx) { }
+
+        Iterator &operator ++() { idx++; return *this; }
+        Iterator &operator --() { idx--; return *this; }
+
+        Iterator operator ++(int) { Iterator copy(*this); idx++; return copy; }
+        Iterator operator --(int) { Iterator copy(*this); idx--; return copy; }
+
+        bool operator ==(const Iterator &other) const { return idx == other.idx; }
+        bool operator !=(const Iterator &other) const { return idx != other.idx; }
+        bool operator  <(const Iterator &other) const { return idx <  other.idx; }
+        bool operator  >(const Iterator &other) const { return idx >  other.idx; }
+        bool operator <=(const Iterator &other) const { return idx <= other.idx; }
+        bool operator >=(const Iterator &other) const { return idx >= other.idx; }
+
+        Iterator &operator +=(difference_type add) { idx += add; return *this; }
+        Iterator &operator -=(difference_type sub) { idx -= sub; return *this; }
+
+        Iterator operator +(difference_type add) const { return Iterator(view, idx + add); }
+        Iterator operator -(difference_type sub) const { return Iterator(view, idx - sub); }
+
+        friend Iterator operator +(difference_type add, const Iterator &it) { return it + add; }
+
+        difference_type operator -(const Iterator &sub) const { return difference_type(idx - sub.idx); }
+
+        Chunk<T> operator[](difference_type i) const { return view[idx + i]; }
+        Chunk<T> operator *() const { return view[idx]; }
+    };
+}
+
+#endif // BUFFERVIEWS_H
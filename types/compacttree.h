@@ -0,0 +1,374 @@
+#ifndef COMPACTTREE_H
+#define COMPACTTREE_H
+
+#include "tree.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * @brief ForwardOnly Label type for unlabeled trees whose nodes only link to their parent, first child and right sibling
+     */
+    struct ForwardOnly { };
+
+    /**
+     * @brief CompactTreeLinks Back-links of a CompactTree node, empty when back_links is false
+     */
+    template <typename Node, bool back_links>
+    struct CompactTreeLinks
+    {
+        Node *left_node  = nullptr;
+        Node *last_child = nullptr;
+    };
+
+    template <typename Node>
+    struct CompactTreeLinks<Node, false> { };
+
+    /**
+     * @brief CompactTree Unlabeled tree node shared by Tree<T, void> and Tree<T, ForwardOnly>
+     * Holds no children map and no label. Without back_links a node is its contents plus three pointers,
+     * at the cost of appending children and deleting a node being linear in the number of siblings.
+     */
+    template <typename T, typename Node, bool back_links>
+    class CompactTree : protected CompactTreeLinks<Node, back_links>
+    {
+        Node *parent      = nullptr;
+        Node *first_child = nullptr;
+        Node *right_node  = nullptr;
+
+        T contents;
+
+        Node *self()             { return static_cast<Node*>(this); }
+        const Node *self() const { return static_cast<const Node*>(this); }
+
+        /**
+         * @brief lastChild Last child of the node, found by walking the siblings without back_links
+         * @return
+         */
+        Node *lastChild() const
+        {
+            if constexpr(back_links)
+                return this->last_child;
+            else
+            {
+                Node *c = first_child;
+                while(c && c->right_node)
+                    c = c->right_node;
+                return c;
+            }
+        }
+
+        void appendChild(Node *child, Node *after)
+        {
+            if(after)
+                after->right_node = child;
+            else
+                first_child = child;
+
+            if constexpr(back_links)
+            {
+                child->left_node = after;
+                this->last_child = child;
+            }
+        }
+
+        /**
+         * @brief unlink Removes the node from the sibling list of its parent
+         */
+        void unlink()
+        {
+            if(!parent)
+                return;
+
+            if constexpr(back_links)
+            {
+                if(this->left_node) this->left_node->right_node = right_node;
+                else                parent->first_child         = right_node;
+
+                if(right_node) right_node->left_node = this->left_node;
+                else           parent->last_child    = this->left_node;
+
+                this->left_node = nullptr;
+            }
+            else
+            {
+                if(parent->first_child == self())
+                    parent->first_child = right_node;
+                else
+                {
+                    Node *left = parent->first_child;
+                    while(left->right_node != self())
+                        left = left->right_node;
+                    left->right_node = right_node;
+                }
+            }
+
+            parent = right_node = nullptr;
+        }
+
+        /**
+         * @brief copyChildren Appends deep copies of the children of other
+         * @param other
+         */
+        void copyChildren(const CompactTree<T, Node, back_links> &other)
+        {
+            Node *last = nullptr;
+            for(const Node *c = other.first_child; c; c = c->right_node)
+            {
+                Node *cc = new Node(*c);
+                cc->parent = self();
+                appendChild(cc, last);
+                last = cc;
+            }
+        }
+
+        /**
+         * @brief takeChildren Moves the children of other to this node
+         * @param other
+         */
+        void takeChildren(CompactTree<T, Node, back_links> &other)
+        {
+            first_child = other.first_child;
+            if constexpr(back_links)
+                this->last_child = other.last_child;
+
+            for(Node *c = first_child; c; c = c->right_node)
+                c->parent = self();
+
+            other.first_child = nullptr;
+            if constexpr(back_links)
+                other.last_child = nullptr;
+        }
+
+    protected:
+
+        template <typename... Args>
+        CompactTree(std::in_place_t, Node *parent, Args&&... args)
+            : parent(parent), contents(std::forward<Args>(args)...) { }
+
+    public:
+
+        /**
+         * @brief CompactTree Creates a tree node containing t
+         * @param t
+         */
+        CompactTree(const T &t) : contents(t) { }
+
+        /**
+         * @brief CompactTree Creates a tree node containing t using move semantics
+         * @param t
+         */
+        CompactTree(T &&t) : contents(std::move(t)) { }
+
+        /**
+         * @brief CompactTree Copy constructor, the copy has no parent
+         * @param other
+         */
+        CompactTree(const CompactTree<T, Node, back_links> &other) : contents(other.contents) { copyChildren(other); }
+
+        /**
+         * @brief CompactTree Move constructor, the new node has no parent
+         * @param other
+         */
+        CompactTree(CompactTree<T, Node, back_links> &&other) : contents(std::move(other.contents)) { takeChildren(other); }
+
+        ~CompactTree()
+        {
+            unlink();
+            clear();
+        }
+
+        /**
+         * @brief operator = Copy operator
+         * @param other
+         * @return
+         */
+        CompactTree<T, Node, back_links> &operator=(const CompactTree<T, Node, back_links> &other)
+        {
+            if(this == &other)
+                return *this;
+
+            contents = other.contents;
+            clear();
+            copyChildren(other);
+
+            return *this;
+        }
+
+        /**
+         * @brief operator = Move operator
+         * @param other
+         * @return
+         */
+        CompactTree<T, Node, back_links> &operator=(CompactTree<T, Node, back_links> &&other)
+        {
+            if(this == &other)
+                return *this;
+
+            contents = std::move(other.contents);
+            clear();
+            takeChildren(other);
+
+            return *this;
+        }
+
+        /**
+         * @brief operator ==
+         * @param other
+         * @return true if both trees contain the same elements in the same order (compared with !=)
+         */
+        bool operator ==(const CompactTree<T, Node, back_links> &other) const
+        {
+            if(contents != other.contents)
+                return false;
+
+            const Node *a = first_child, *b = other.first_child;
+            for(; a && b; a = a->right_node, b = b->right_node)
+                if(*a != *b)
+                    return false;
+
+            return a == nullptr && b == nullptr;
+        }
+
+        /**
+         * @brief operator !=
+         * @param other
+         * @return true if both trees contain different elements or the same elements in a different order
+         */
+        bool operator !=(const CompactTree<T, Node, back_links> &other) const { return !(*this == other); }
+
+        /**
+         * @brief getContents Access contained data
+         * @return Reference to contained data
+         */
+        T &getContents() { return contents; }
+
+        Node *getParent() { return parent; }
+
+        /**
+         * @brief operator * same as getContents()
+         * @return
+         */
+        T &operator*() { return getContents(); }
+
+        void addChild(const T &t) { emplaceChild(t); }
+        void addChild(T &&t)      { emplaceChild(std::move(t)); }
+
+        /**
+         * @brief emplaceChild Appends a child with contents constructed in place from args
+         * @param args
+         * @return The new child
+         */
+        template <typename... Args>
+        Node *emplaceChild(Args&&... args)
+        {
+            Node *child = new Node(std::in_place, self(), std::forward<Args>(args)...);
+            appendChild(child, lastChild());
+            return child;
+        }
+
+        /**
+         * @brief addChildren Appends a child for every element of range
+         * @param range Anything iterable with elements T can be constructed from
+         */
+        template <typename Range>
+        void addChildren(const Range &range)
+        {
+            Node *last = lastChild();
+            for(const auto &t : range)
+            {
+                Node *child = new Node(std::in_place, self(), t);
+                appendChild(child, last);
+                last = child;
+            }
+        }
+
+        void addChildren(std::initializer_list<T> list) { addChildren<std::initializer_list<T>>(list); }
+
+        class TreeIterator
+        {
+            Node* ptr;
+            Node* prePtr;
+
+        public:
+            using iterator_category = std::conditional_t<back_links, std::bidirectional_iterator_tag, std::forward_iterator_tag>;
+            using value_type        = Node;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = Node*;
+            using reference         = Node&;
+
+            TreeIterator(Node* ptr, Node* pp = nullptr) { this->ptr = ptr; this->prePtr = pp; }
+
+            TreeIterator &operator ++() { prePtr = ptr; ptr = ptr->right_node; return *this; }
+            TreeIterator &operator --()
+            {
+                static_assert(back_links, "Tree<T, ForwardOnly> children can only be iterated forward");
+                Node *n = ptr ? ptr->left_node : prePtr;
+                prePtr = ptr; ptr = n;
+                return *this;
+            }
+
+            TreeIterator operator ++(int) { TreeIterator copy(*this); ++*this; return copy; }
+            TreeIterator operator --(int) { TreeIterator copy(*this); --*this; return copy; }
+
+            bool operator ==(const TreeIterator &other) const { return ptr == other.ptr; }
+            bool operator !=(const TreeIterator &other) const { return ptr != other.ptr; }
+
+            Node &operator *()  const { return *ptr; }
+            Node *operator ->() const { return ptr; }
+
+            Node *getPtr() { return ptr; };
+        };
+
+        TreeIterator begin() const { return TreeIterator(first_child); }
+        TreeIterator end()   const { return TreeIterator(nullptr, back_links ? lastChild() : nullptr); }
+
+        /**
+         * @brief clear Deletes all children
+         */
+        void clear()
+        {
+            Node *c = first_child;
+            first_child = nullptr;
+            if constexpr(back_links)
+                this->last_child = nullptr;
+
+            while(c)
+            {
+                Node *next = c->right_node;
+                c->parent = nullptr;
+                delete c;
+                c = next;
+            }
+        }
+    };
+
+    /**
+     * @brief Tree<T, void> Unlabeled tree with links to both siblings and to the last child
+     */
+    template <typename T>
+    class Tree<T, void> : public CompactTree<T, Tree<T, void>, true>
+    {
+        friend class CompactTree<T, Tree<T, void>, true>;
+    public:
+        using CompactTree<T, Tree<T, void>, true>::CompactTree;
+    };
+
+    /**
+     * @brief Tree<T, ForwardOnly> Unlabeled tree with only forward links, see CompactTree
+     */
+    template <typename T>
+    class Tree<T, ForwardOnly> : public CompactTree<T, Tree<T, ForwardOnly>, false>
+    {
+        friend class CompactTree<T, Tree<T, ForwardOnly>, false>;
+    public:
+        using CompactTree<T, Tree<T, ForwardOnly>, false>::CompactTree;
+    };
+}
+
+#endif // COMPACTTREE_H
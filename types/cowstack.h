@@ -0,0 +1,185 @@
+#ifndef COWSTACK_H
+#define COWSTACK_H
+
+#include "stack.h"
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * @brief CowStack Stack whose copies share one buffer until one of them is modified
+     * Copying is O(1): it only increments an atomic reference count. The first mutating call on a copy that shares its
+     * buffer clones it, so read-only snapshots never copy elements. Distinct CowStack objects sharing a buffer may be
+     * used from different threads; a single CowStack object is no more thread safe than a Stack.
+     * References and iterators obtained through const access stay valid until the next mutating call on this object.
+     * A moved-from CowStack holds no buffer and behaves as an empty stack until it is modified.
+     * @tparam T
+     */
+    template <typename T>
+    class CowStack
+    {
+        struct Shared
+        {
+            std::atomic<std::size_t> refs{1};
+            Stack<T> stack;
+
+            Shared(Stack<T> &&stack) : stack(std::move(stack)) { }
+            Shared(const Stack<T> &stack) : stack(stack) { }
+        };
+
+        Shared *shared;
+
+        static const Stack<T> &empty_stack()
+        {
+            static const Stack<T> empty(0);
+            return empty;
+        }
+
+        void release()
+        {
+            if(shared && shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete shared;
+            shared = nullptr;
+        }
+
+        /**
+         * @brief detach Makes the buffer exclusive to this object, cloning it if it is shared
+         * @return
+         */
+        Stack<T> &detach()
+        {
+            if(!shared)
+                shared = new Shared(Stack<T>());
+            else if(shared->refs.load(std::memory_order_acquire) != 1)
+            {
+                Shared *clone = new Shared(shared->stack);
+                release();
+                shared = clone;
+            }
+            return shared->stack;
+        }
+
+    public:
+        /**
+         * @brief CowStack
+         * @param size Optional argument to set the initial amount of elements to hold
+         */
+        CowStack(std::size_t size = 8) : shared(new Shared(Stack<T>(size))) { }
+
+        /**
+         * @brief CowStack Takes over the buffer of stack
+         * @param stack
+         */
+        CowStack(Stack<T> &&stack) : shared(new Shared(std::move(stack))) { }
+
+        CowStack(std::initializer_list<T> list, bool direction = true) : shared(new Shared(Stack<T>(list, direction))) { }
+
+        CowStack(const CowStack<T> &other) : shared(other.shared) { if(shared) shared->refs.fetch_add(1, std::memory_order_relaxed); }
+        CowStack(CowStack<T> &&other) noexcept : shared(std::exchange(other.shared, nullptr)) { }
+
+        ~CowStack() { release(); }
+
+        CowStack<T> &operator=(const CowStack<T> &other)
+        {
+            if(shared != other.shared)
+            {
+                if(other.shared)
+                    other.shared->refs.fetch_add(1, std::memory_order_relaxed);
+                release();
+                shared = other.shared;
+            }
+            return *this;
+        }
+
+        CowStack<T> &operator=(CowStack<T> &&other) noexcept
+        {
+            if(this != &other)
+                std::swap(shared, other.shared);
+            return *this;
+        }
+
+        bool operator ==(const CowStack<T> &other) const { return shared == other.shared || view() == other.view(); }
+        bool operator !=(const CowStack<T> &other) const { return !(*this == other); }
+
+        /**
+         * @brief view Read-only access to the whole Stack API
+         * @return
+         */
+        const Stack<T> &view() const { return shared ? shared->stack : empty_stack(); }
+
+        /**
+         * @brief modify Calls f with mutable access to the whole Stack API, clones a shared buffer first
+         * References into the stack must not outlive the call, a later copy would share the buffer they point into.
+         * @param f
+         */
+        template <typename F>
+        void modify(F f) { f(detach()); }
+
+        /**
+         * @brief shares
+         * @param other
+         * @return true if both stacks use the same buffer
+         */
+        bool shares(const CowStack<T> &other) const { return shared == other.shared; }
+
+        /**
+         * @brief useCount
+         * @return Number of CowStack objects sharing the buffer, 0 for a moved-from stack
+         */
+        std::size_t useCount() const { return shared ? shared->refs.load(std::memory_order_relaxed) : 0; }
+
+        /**
+         * @brief operator [] Access element by index from the top without cloning
+         * @param idx
+         * @return
+         */
+        const T &operator[](std::size_t idx) const { return view()[idx]; }
+
+        /**
+         * @brief set Replaces the element at index idx from the top, clones a shared buffer first
+         * There is no mutable operator [], a reference kept past a later copy would write into the shared buffer.
+         * @param idx
+         * @param val
+         */
+        void set(std::size_t idx, const T &val) { detach()[idx] = val; }
+
+        std::size_t size() const { return view().size(); }
+        bool empty() const { return !size(); }
+
+        void push_top(const T &val)    { detach().push_top(val); }
+        void push_bottom(const T &val) { detach().push_bottom(val); }
+
+        void pop_top()    { if(size()) detach().pop_top(); }
+        void pop_bottom() { if(size()) detach().pop_bottom(); }
+
+        T pull_top()    { return size() ? detach().pull_top() : T(); }
+        T pull_bottom() { return size() ? detach().pull_bottom() : T(); }
+
+        /**
+         * @brief clear Removes all elements, a shared buffer is left to the other copies
+         */
+        void clear()
+        {
+            bool direction = getDirection();
+            release();
+            shared = new Shared(Stack<T>());
+            shared->stack.setDirection(direction);
+        }
+
+        bool getDirection() const { return view().getDirection(); }
+        void setDirection(bool dir) { if(dir != getDirection()) detach().setDirection(dir); }
+        void reverse() { detach().reverse(); }
+
+        /**
+         * @brief begin Read-only iteration from the top
+         */
+        DirectionalIterator<const T> begin() const { return view().begin(); }
+        DirectionalIterator<const T> end()   const { return view().end(); }
+    };
+}
+
+#endif // COWSTACK_H
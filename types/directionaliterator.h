@@ -1,23 +1,45 @@
 #ifndef DIRECTIONALITERATOR_H
 #define DIRECTIONALITERATOR_H
 
+#include <cstddef>
 #include <iterator>
+#include <type_traits>
 
 namespace Types
 {
+    /**
+     * @brief DirectionalIterator Random access iterator over contiguous memory walking forward or backward
+     * The direction is only known at run time, so it models std::random_access_iterator but not std::contiguous_iterator.
+     * Use ContiguousIterator where the memory order is fixed.
+     */
     template <typename T>
-    class DirectionalIterator : public std::iterator<std::random_access_iterator_tag, T>
+    class DirectionalIterator
     {
-        T* ptr;
-        bool direction;
+        T* ptr = nullptr;
+        bool direction = true;
 
     public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::remove_cv_t<T>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T*;
+        using reference         = T&;
 
-        DirectionalIterator(T* ptr, bool direction = true) { this->ptr = ptr; this->direction = direction; }
-        DirectionalIterator(const DirectionalIterator<T> &other) { this->ptr = other.ptr; this->direction = other.direction; }
+        DirectionalIterator() = default;
+        DirectionalIterator(T* ptr, bool direction = true) : ptr(ptr), direction(direction) { }
 
-        const DirectionalIterator<T> &operator ++() { direction ? ptr++ : ptr--; return *this; }
-        const DirectionalIterator<T> &operator --() { direction ? ptr-- : ptr++; return *this; }
+        /**
+         * @brief DirectionalIterator Converts an iterator over V, e.g. a mutable iterator into a const one
+         * @param other
+         */
+        template <typename V, typename = std::enable_if_t<std::is_convertible<V*, T*>::value>>
+        DirectionalIterator(const DirectionalIterator<V> &other) : ptr(other.ptr), direction(other.direction) { }
+
+        template <typename> friend class DirectionalIterator;
+
+        DirectionalIterator<T> &operator ++() { direction ? ptr++ : ptr--; return *this; }
+        DirectionalIterator<T> &operator --() { direction ? ptr-- : ptr++; return *this; }
 
         DirectionalIterator<T> operator ++(int) { DirectionalIterator<T> copy(*this); direction ? ptr++ : ptr--; return copy; }
         DirectionalIterator<T> operator --(int) { DirectionalIterator<T> copy(*this); direction ? ptr-- : ptr++; return copy; }
@@ -30,15 +52,17 @@ namespace Types
         bool operator  <=(const DirectionalIterator<T> &other) const { return direction ? ptr <= other.ptr : ptr >= other.ptr; }
         bool operator  >=(const DirectionalIterator<T> &other) const { return direction ? ptr >= other.ptr : ptr <= other.ptr; }
 
-        DirectionalIterator<T> &operator +=(const long int &add) { direction ? ptr += add : ptr -= add; return *this; }
-        DirectionalIterator<T> &operator -=(const long int &sub) { direction ? ptr -= sub : ptr += sub; return *this; }
+        DirectionalIterator<T> &operator +=(difference_type add) { direction ? ptr += add : ptr -= add; return *this; }
+        DirectionalIterator<T> &operator -=(difference_type sub) { direction ? ptr -= sub : ptr += sub; return *this; }
 
-        DirectionalIterator<T> operator +(const long int &add) const { DirectionalIterator<T> copy(*this); copy += add; return copy; }
-        DirectionalIterator<T> operator -(const long int &sub) const { DirectionalIterator<T> copy(*this); copy -= sub; return copy; }
+        DirectionalIterator<T> operator +(difference_type add) const { DirectionalIterator<T> copy(*this); copy += add; return copy; }
+        DirectionalIterator<T> operator -(difference_type sub) const { DirectionalIterator<T> copy(*this); copy -= sub; return copy; }
 
-        ptrdiff_t operator -(DirectionalIterator<T> &sub) const { return direction ? ptr - sub.ptr : sub.ptr - ptr; }
+        friend DirectionalIterator<T> operator +(difference_type add, const DirectionalIterator<T> &it) { return it + add; }
 
-        T &operator[](std::size_t idx) { return ptr[direction ? idx : -idx]; }
+        difference_type operator -(const DirectionalIterator<T> &sub) const { return direction ? ptr - sub.ptr : sub.ptr - ptr; }
+
+        T &operator[](difference_type idx) const { return ptr[direction ? idx : -idx]; }
         T &operator *()  const { return *ptr; }
         T *operator ->() const { return ptr; }
 
@@ -60,6 +84,73 @@ namespace Types
          */
         void reverse() { direction = !direction; }
     };
+
+    /**
+     * @brief ContiguousIterator Iterator walking contiguous memory forward, models std::contiguous_iterator in C++20
+     * Standard algorithms can lower copies and fills over it to memmove and vectorized loops.
+     */
+    template <typename T>
+    class ContiguousIterator
+    {
+        T* ptr = nullptr;
+
+    public:
+#if __cplusplus >= 202002L
+        using iterator_concept  = std::contiguous_iterator_tag;
+#else
+        using iterator_concept  = std::random_access_iterator_tag;
+#endif
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::remove_cv_t<T>;
+        using element_type      = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T*;
+        using reference         = T&;
+
+        ContiguousIterator() = default;
+        explicit ContiguousIterator(T* ptr) : ptr(ptr) { }
+
+        /**
+         * @brief ContiguousIterator Converts an iterator over V, e.g. a mutable iterator into a const one
+         * @param other
+         */
+        template <typename V, typename = std::enable_if_t<std::is_convertible<V*, T*>::value>>
+        ContiguousIterator(const ContiguousIterator<V> &other) : ptr(other.ptr) { }
+
+        template <typename> friend class ContiguousIterator;
+
+        ContiguousIterator<T> &operator ++() { ptr++; return *this; }
+        ContiguousIterator<T> &operator --() { ptr--; return *this; }
+
+        ContiguousIterator<T> operator ++(int) { return ContiguousIterator<T>(ptr++); }
+        ContiguousIterator<T> operator --(int) { return ContiguousIterator<T>(ptr--); }
+
+        bool operator ==(const ContiguousIterator<T> &other) const { return ptr == other.ptr; }
+        bool operator !=(const ContiguousIterator<T> &other) const { return ptr != other.ptr; }
+        bool operator  <(const ContiguousIterator<T> &other) const { return ptr <  other.ptr; }
+        bool operator  >(const ContiguousIterator<T> &other) const { return ptr >  other.ptr; }
+        bool operator <=(const ContiguousIterator<T> &other) const { return ptr <= other.ptr; }
+        bool operator >=(const ContiguousIterator<T> &other) const { return ptr >= other.ptr; }
+
+        ContiguousIterator<T> &operator +=(difference_type add) { ptr += add; return *this; }
+        ContiguousIterator<T> &operator -=(difference_type sub) { ptr -= sub; return *this; }
+
+        ContiguousIterator<T> operator +(difference_type add) const { return ContiguousIterator<T>(ptr + add); }
+        ContiguousIterator<T> operator -(difference_type sub) const { return ContiguousIterator<T>(ptr - sub); }
+
+        friend ContiguousIterator<T> operator +(difference_type add, const ContiguousIterator<T> &it) { return it + add; }
+
+        difference_type operator -(const ContiguousIterator<T> &sub) const { return ptr - sub.ptr; }
+
+        T &operator[](difference_type idx) const { return ptr[idx]; }
+        T &operator *()  const { return *ptr; }
+        T *operator ->() const { return ptr; }
+
+        /**
+         * @brief operator DirectionalIterator Same position, walking forward
+         */
+        operator DirectionalIterator<T>() const { return DirectionalIterator<T>(ptr, true); }
+    };
 }
 
 #endif // DIRECTIONALITERATOR_H
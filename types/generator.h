@@ -0,0 +1,114 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * @brief Generator Lazily evaluated input range produced by a coroutine with co_yield
+     * Yielded objects are referenced, not copied, and stay valid until the generator is resumed again.
+     * @tparam T Reference type or value type of the yielded elements
+     */
+    template <typename T>
+    class Generator : public std::ranges::view_interface<Generator<T>>
+    {
+    public:
+        using value_type = std::remove_cvref_t<T>;
+        using reference  = std::conditional_t<std::is_reference_v<T>, T, T&>;
+
+        class promise_type
+        {
+            std::remove_reference_t<reference> *current = nullptr;
+            std::exception_ptr exception;
+
+            friend class Generator<T>;
+
+        public:
+            Generator<T> get_return_object() { return Generator<T>(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend()   noexcept { return {}; }
+
+            std::suspend_always yield_value(std::remove_reference_t<reference> &val)  noexcept { current = std::addressof(val); return {}; }
+            std::suspend_always yield_value(std::remove_reference_t<reference> &&val) noexcept { current = std::addressof(val); return {}; }
+
+            void return_void() { }
+            void unhandled_exception() { exception = std::current_exception(); }
+
+            template <typename V>
+            V &&await_transform(V &&) = delete;
+        };
+
+        class Iterator
+        {
+            std::coroutine_handle<promise_type> handle;
+
+        public:
+            using iterator_concept  = std::input_iterator_tag;
+            using value_type        = Generator<T>::value_type;
+            using difference_type   = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(std::coroutine_handle<promise_type> handle) : handle(handle) { }
+
+            Iterator &operator ++()
+            {
+                handle.resume();
+                if(handle.done() && handle.promise().exception)
+                    std::rethrow_exception(handle.promise().exception);
+                return *this;
+            }
+            void operator ++(int) { ++*this; }
+
+            reference operator *() const { return static_cast<reference>(*handle.promise().current); }
+
+            bool operator ==(std::default_sentinel_t) const { return !handle || handle.done(); }
+        };
+
+        Generator() = default;
+        Generator(const Generator<T> &) = delete;
+        Generator(Generator<T> &&other) noexcept : handle(std::exchange(other.handle, nullptr)) { }
+
+        ~Generator() { if(handle) handle.destroy(); }
+
+        Generator<T> &operator=(const Generator<T> &) = delete;
+        Generator<T> &operator=(Generator<T> &&other) noexcept
+        {
+            if(this != &other)
+            {
+                if(handle) handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief begin Runs the coroutine up to the first co_yield, may only be called once
+         * @return
+         */
+        Iterator begin()
+        {
+            Iterator it(handle);
+            if(handle)
+                ++it;
+            return it;
+        }
+
+        std::default_sentinel_t end() const { return std::default_sentinel; }
+
+    private:
+        std::coroutine_handle<promise_type> handle = nullptr;
+
+        explicit Generator(std::coroutine_handle<promise_type> handle) : handle(handle) { }
+    };
+}
+
+#endif // GENERATOR_H
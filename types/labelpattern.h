@@ -0,0 +1,155 @@
+#ifndef LABELPATTERN_H
+#define LABELPATTERN_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Types
+{
+    /**
+     * @brief LabelPattern Path of labels with wildcards, as used by Tree::query()
+     * Segments are separated by '/'. A segment "*" matches any single label and "**" any number of levels, including
+     * none; other segments are matched against one label with '*' standing for any run of characters and '?' for one
+     * character. Empty segments are ignored, so "a//b/" is the same as "a/b".
+     */
+    class LabelPattern
+    {
+    public:
+        enum Kind { LITERAL, GLOB, ANY, RECURSIVE };
+
+        struct Segment
+        {
+            Kind kind;
+            std::string text;
+        };
+
+    private:
+        std::vector<Segment> segs;
+        std::size_t recursive = 0;
+
+    public:
+        LabelPattern(std::string_view pattern)
+        {
+            while(!pattern.empty())
+            {
+                std::size_t slash = pattern.find('/');
+                std::string_view seg = pattern.substr(0, slash);
+                pattern = slash == std::string_view::npos ? std::string_view() : pattern.substr(slash + 1);
+
+                if(seg.empty())
+                    continue;
+
+                if(seg == "**")
+                {
+                    if(!segs.empty() && segs.back().kind == RECURSIVE)
+                        continue;
+                    segs.push_back({ RECURSIVE, std::string(seg) });
+                    recursive++;
+                }
+                else if(seg == "*")
+                    segs.push_back({ ANY, std::string(seg) });
+                else
+                    segs.push_back({ seg.find_first_of("*?") == std::string_view::npos ? LITERAL : GLOB, std::string(seg) });
+            }
+        }
+
+        const std::vector<Segment> &segments() const { return segs; }
+        std::size_t size() const { return segs.size(); }
+
+        const Segment &operator[](std::size_t idx) const { return segs[idx]; }
+
+        /**
+         * @brief recursiveCount
+         * @return Number of "**" segments
+         */
+        std::size_t recursiveCount() const { return recursive; }
+
+        /**
+         * @brief glob Matches label against a segment with '*' and '?' wildcards
+         * @param pattern
+         * @param label
+         * @return
+         */
+        static bool glob(std::string_view pattern, std::string_view label)
+        {
+            std::size_t p = 0, l = 0;
+            std::size_t star = std::string_view::npos, resume = 0;
+
+            while(l < label.size())
+            {
+                if(p < pattern.size() && (pattern[p] == '?' || pattern[p] == label[l]))
+                {
+                    p++;
+                    l++;
+                }
+                else if(p < pattern.size() && pattern[p] == '*')
+                {
+                    star = p++;
+                    resume = l;
+                }
+                else if(star != std::string_view::npos)
+                {
+                    p = star + 1;
+                    l = ++resume;
+                }
+                else
+                    return false;
+            }
+
+            while(p < pattern.size() && pattern[p] == '*')
+                p++;
+            return p == pattern.size();
+        }
+
+        /**
+         * @brief matches Matches one label against a segment other than "**"
+         * @param idx Index of the segment
+         * @param label
+         * @return
+         */
+        bool matches(std::size_t idx, std::string_view label) const
+        {
+            switch(segs[idx].kind)
+            {
+            case LITERAL:   return segs[idx].text == label;
+            case GLOB:      return glob(segs[idx].text, label);
+            default:        return true;
+            }
+        }
+
+        /**
+         * @brief matchPath Matches a whole path of labels against the segments [from, to)
+         * @param from
+         * @param to
+         * @param labels Labels from the top of the path down
+         * @return
+         */
+        bool matchPath(std::size_t from, std::size_t to, const std::vector<std::string_view> &labels) const
+        {
+            // reachable[j]: the segments so far can match the first j labels
+            std::vector<char> reachable(labels.size() + 1, 0);
+            reachable[0] = 1;
+
+            for(std::size_t s = from; s < to; s++)
+            {
+                if(segs[s].kind == RECURSIVE)
+                {
+                    for(std::size_t j = 1; j <= labels.size(); j++)
+                        reachable[j] = reachable[j] || reachable[j - 1];
+                }
+                else
+                {
+                    for(std::size_t j = labels.size(); j > 0; j--)
+                        reachable[j] = reachable[j - 1] && matches(s, labels[j - 1]);
+                    reachable[0] = 0;
+                }
+            }
+
+            return reachable[labels.size()];
+        }
+    };
+}
+
+#endif // LABELPATTERN_H
@@ -0,0 +1,201 @@
+#ifndef MONOTONIC_H
+#define MONOTONIC_H
+
+#include "stack.h"
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * @brief MonotonicStack Stack that removes every element ranking below a newly pushed one
+     * From the top to the bottom the elements never rank lower, so the bottom is the highest ranked element pushed
+     * after every element ranking above it. With the default std::less this answers "next greater element" queries:
+     * the elements removed by a push have found their next greater element.
+     * @tparam T
+     * @tparam Compare Strict weak ordering, Compare(a, b) is true if a ranks below b
+     */
+    template <typename T, typename Compare = std::less<T>>
+    class MonotonicStack
+    {
+        Stack<T> items;
+        Compare comp;
+
+    public:
+        /**
+         * @brief MonotonicStack
+         * @param size Initial capacity
+         * @param comp
+         */
+        MonotonicStack(std::size_t size = 8, Compare comp = Compare()) : items(size), comp(std::move(comp)) { }
+
+        /**
+         * @brief push Removes the elements ranking below t from the top and pushes t, amortized O(1)
+         * @param t
+         * @param removed Called with every removed element before it is removed
+         * @return Number of removed elements
+         */
+        template <typename F>
+        std::size_t push(const T &t, F &&removed)
+        {
+            std::size_t n = 0;
+            while(items.size() && comp(*items.begin(), t))
+            {
+                removed(*items.begin());
+                items.pop_top();
+                n++;
+            }
+
+            items.push_top(t);
+            return n;
+        }
+
+        std::size_t push(const T &t) { return push(t, [](const T &) { }); }
+
+        /**
+         * @brief top
+         * @return The last pushed element
+         */
+        const T &top() const
+        {
+            if(!items.size())
+                throw "MonotonicStack is empty";
+
+            return *items.begin();
+        }
+
+        /**
+         * @brief bottom
+         * @return The highest ranked element
+         */
+        const T &bottom() const
+        {
+            if(!items.size())
+                throw "MonotonicStack is empty";
+
+            return *items.rbegin();
+        }
+
+        /**
+         * @brief pop_top Removes the last pushed element, if there is one
+         */
+        void pop_top() { items.pop_top(); }
+
+        std::size_t size() const { return items.size(); }
+        bool empty() const { return !items.size(); }
+        void clear() { items.clear(); }
+
+        DirectionalIterator<T> begin() const { return items.begin(); }
+        DirectionalIterator<T> end()   const { return items.end(); }
+    };
+
+    /**
+     * @brief MonotonicDeque Sliding window extremum, front() is the highest ranked element of the window
+     * Every pushed element gets a position, pushes without one count up from 0. Elements ranking below a newer one
+     * can never become the front and are dropped on push; elements that leave the window are evicted from the front.
+     * Both ends are those of a Stack, which slides its elements back instead of growing while at most half full, so
+     * a window of bounded size stops allocating once the buffer has grown to fit it.
+     * @tparam T
+     * @tparam Compare Strict weak ordering, Compare(a, b) is true if a ranks below b; std::less gives sliding maximum
+     */
+    template <typename T, typename Compare = std::less<T>>
+    class MonotonicDeque
+    {
+        struct Entry
+        {
+            T value;
+            std::size_t position;
+        };
+
+        Stack<Entry> items;         // newest at the top, front() at the bottom
+        Compare comp;
+        std::size_t window;
+        std::size_t next = 0;
+
+        const Entry &frontEntry() const
+        {
+            if(!items.size())
+                throw "MonotonicDeque is empty";
+
+            return *items.rbegin();
+        }
+
+    public:
+        /**
+         * @brief MonotonicDeque
+         * @param window Number of positions an element stays in the window, 0 to only evict with evict_before()
+         * @param comp
+         */
+        MonotonicDeque(std::size_t window = 0, Compare comp = Compare()) : items(window ? window : 8), comp(std::move(comp)), window(window) { }
+
+        /**
+         * @brief push Adds t at position and evicts the elements outside the window ending there, amortized O(1)
+         * Positions must not decrease between pushes.
+         * @param t
+         * @param position
+         */
+        void push(const T &t, std::size_t position)
+        {
+            while(items.size() && comp(items.begin()->value, t))
+                items.pop_top();
+
+            items.push_top(Entry{t, position});
+            next = position + 1;
+
+            if(window)
+                evict_before(position + 1 > window ? position + 1 - window : 0);
+        }
+
+        /**
+         * @brief push Adds t at the position following the last push
+         * @param t
+         */
+        void push(const T &t) { push(t, next); }
+
+        /**
+         * @brief evict_before Removes the elements at positions below position
+         * @param position
+         */
+        void evict_before(std::size_t position)
+        {
+            while(items.size() && items.rbegin()->position < position)
+                items.pop_bottom();
+        }
+
+        /**
+         * @brief front
+         * @return The highest ranked element in the window
+         */
+        const T &front() const { return frontEntry().value; }
+
+        /**
+         * @brief front_position
+         * @return Position of front()
+         */
+        std::size_t front_position() const { return frontEntry().position; }
+
+        /**
+         * @brief next_position
+         * @return Position used by the next push without one
+         */
+        std::size_t next_position() const { return next; }
+
+        std::size_t getWindow() const { return window; }
+
+        /**
+         * @brief size
+         * @return Number of elements that can still become the front, not the window size
+         */
+        std::size_t size() const { return items.size(); }
+        bool empty() const { return !items.size(); }
+
+        /**
+         * @brief clear Removes all elements, positions continue after the last push
+         */
+        void clear() { items.clear(); }
+    };
+}
+
+#endif // MONOTONIC_H
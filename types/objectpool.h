@@ -0,0 +1,267 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include "stack.h"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Types
+{
+    /**
+     * @brief ObjectPool Recycles heap allocated objects through per-thread caches and a shared depot
+     * Every thread keeps its own Stack of free objects and only locks the depot to exchange a whole magazine of
+     * objects: when its cache runs empty it takes up to one magazine, when the cache holds two magazines it hands the
+     * colder one back. Acquire and release are therefore thread-local pulls and pushes in the common case.
+     * Handles must not outlive the pool. Objects cached by other threads when the pool is destroyed are deleted when
+     * those threads exit.
+     * @tparam T
+     */
+    template <typename T>
+    class ObjectPool
+    {
+        struct Depot
+        {
+            std::mutex lock;
+            Stack<T*> objects;
+            bool closed = false;
+
+            std::size_t magazine;
+            std::function<T*()> create;
+            std::atomic<std::size_t> created{0};
+
+            ~Depot() { for(T *t : objects) delete t; }
+        };
+
+        struct Cache
+        {
+            std::shared_ptr<Depot> depot;
+            Stack<T*> objects;
+
+            Cache(std::shared_ptr<Depot> depot) : depot(std::move(depot)), objects(2 * this->depot->magazine) { }
+
+            /**
+             * @brief flush Returns all cached objects to the depot, or deletes them if the pool is gone
+             */
+            void flush()
+            {
+                std::lock_guard<std::mutex> guard(depot->lock);
+                while(objects.size())
+                {
+                    T *t = objects.pull_top();
+                    if(depot->closed)
+                        delete t;
+                    else
+                        depot->objects.push_top(t);
+                }
+            }
+        };
+
+        struct ThreadCaches
+        {
+            std::vector<Cache*> caches;
+
+            ~ThreadCaches()
+            {
+                for(Cache *c : caches)
+                {
+                    c->flush();
+                    delete c;
+                }
+            }
+        };
+
+        static ThreadCaches &threadCaches()
+        {
+            static thread_local ThreadCaches caches;
+            return caches;
+        }
+
+        std::shared_ptr<Depot> depot;
+
+        Cache &cache()
+        {
+            std::vector<Cache*> &caches = threadCaches().caches;
+            for(Cache *c : caches)
+                if(c->depot == depot)
+                    return *c;
+
+            for(std::size_t i = caches.size(); i-- > 0;)
+            {
+                std::unique_lock<std::mutex> guard(caches[i]->depot->lock);
+                if(caches[i]->depot->closed)
+                {
+                    guard.unlock();
+                    caches[i]->flush();
+                    delete caches[i];
+                    caches.erase(caches.begin() + i);
+                }
+            }
+
+            caches.push_back(new Cache(depot));
+            return *caches.back();
+        }
+
+        void refill(Cache &c)
+        {
+            std::lock_guard<std::mutex> guard(depot->lock);
+            for(std::size_t i = 0; i < depot->magazine && depot->objects.size(); i++)
+                c.objects.push_top(depot->objects.pull_top());
+        }
+
+        void spill(Cache &c)
+        {
+            std::lock_guard<std::mutex> guard(depot->lock);
+            for(std::size_t i = 0; i < depot->magazine; i++)
+                depot->objects.push_top(c.objects.pull_bottom());
+        }
+
+    public:
+        /**
+         * @brief Handle Owns an object of the pool and returns it on destruction
+         */
+        class Handle
+        {
+            ObjectPool<T> *pool = nullptr;
+            T *object = nullptr;
+
+        public:
+            Handle() = default;
+            Handle(ObjectPool<T> *pool, T *object) : pool(pool), object(object) { }
+
+            Handle(const Handle &) = delete;
+            Handle(Handle &&other) : pool(other.pool), object(std::exchange(other.object, nullptr)) { }
+
+            ~Handle() { reset(); }
+
+            Handle &operator=(const Handle &) = delete;
+            Handle &operator=(Handle &&other)
+            {
+                if(this != &other)
+                {
+                    reset();
+                    pool = other.pool;
+                    object = std::exchange(other.object, nullptr);
+                }
+                return *this;
+            }
+
+            /**
+             * @brief reset Returns the object to the pool early
+             */
+            void reset()
+            {
+                if(object)
+                    pool->release(std::exchange(object, nullptr));
+            }
+
+            T *get() const { return object; }
+            T &operator *() const { return *object; }
+            T *operator ->() const { return object; }
+
+            explicit operator bool() const { return object; }
+        };
+
+        /**
+         * @brief ObjectPool
+         * @param magazine Number of objects moved between a thread cache and the depot at once
+         * @param create Makes a new object when no free one is available, it must be allocated with new
+         */
+        ObjectPool(std::size_t magazine = 32, std::function<T*()> create = [] { return new T(); }) : depot(std::make_shared<Depot>())
+        {
+            depot->magazine = magazine ? magazine : 1;
+            depot->create = std::move(create);
+        }
+
+        ObjectPool(const ObjectPool<T> &) = delete;
+        ObjectPool<T> &operator=(const ObjectPool<T> &) = delete;
+
+        ~ObjectPool()
+        {
+            std::vector<Cache*> &caches = threadCaches().caches;
+            for(std::size_t i = 0; i < caches.size(); i++)
+            {
+                if(caches[i]->depot == depot)
+                {
+                    for(T *t : caches[i]->objects)
+                        delete t;
+                    delete caches[i];
+                    caches.erase(caches.begin() + i);
+                    break;
+                }
+            }
+
+            std::lock_guard<std::mutex> guard(depot->lock);
+            depot->closed = true;
+            for(T *t : depot->objects)
+                delete t;
+            depot->objects = Stack<T*>();
+        }
+
+        /**
+         * @brief acquire Takes a free object or creates one
+         * Recycled objects are returned as they were released.
+         * @return The object, owned by the caller until release()
+         */
+        T *acquire()
+        {
+            Cache &c = cache();
+            if(!c.objects.size())
+                refill(c);
+
+            if(c.objects.size())
+                return c.objects.pull_top();
+
+            depot->created.fetch_add(1, std::memory_order_relaxed);
+            return depot->create();
+        }
+
+        /**
+         * @brief release Returns an object from acquire() to the pool, on any thread
+         * @param t
+         */
+        void release(T *t)
+        {
+            Cache &c = cache();
+            c.objects.push_top(t);
+
+            if(c.objects.size() >= 2 * depot->magazine)
+                spill(c);
+        }
+
+        /**
+         * @brief get Acquires an object owned by a handle
+         * @return
+         */
+        Handle get() { return Handle(this, acquire()); }
+
+        /**
+         * @brief created
+         * @return Number of objects the pool has made so far
+         */
+        std::size_t created() const { return depot->created.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief depotSize
+         * @return Number of free objects in the shared depot
+         */
+        std::size_t depotSize() const
+        {
+            std::lock_guard<std::mutex> guard(depot->lock);
+            return depot->objects.size();
+        }
+
+        /**
+         * @brief cachedSize
+         * @return Number of free objects in the cache of the calling thread
+         */
+        std::size_t cachedSize() { return cache().objects.size(); }
+    };
+}
+
+#endif // OBJECTPOOL_H
@@ -0,0 +1,388 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+#include "stack.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Types
+{
+    template <typename T>
+    class SoAColumn;
+
+    /**
+     * Fork-join kernels over contiguous ranges, and over the buffers of a Stack or a SoAColumn. A range is split into
+     * at most one part per pool thread, and only into parts of at least Policy::threshold elements, so small ranges
+     * run serially on the calling thread.
+     */
+    namespace Parallel
+    {
+        /**
+         * @brief ThreadPool Fixed set of worker threads that run the parts of one job at a time
+         * The calling thread works on the job as well, so a pool of n threads starts n - 1 workers. Jobs submitted
+         * from inside a running part, or from several threads at once, are run serially or one after the other.
+         */
+        class ThreadPool
+        {
+            std::vector<std::thread> workers;
+
+            std::mutex lock;
+            std::condition_variable wake, done;
+            std::mutex submit;   // one job at a time
+
+            void (*call)(void *, size_t) = nullptr;
+            void *context = nullptr;
+            size_t parts = 0;
+            std::atomic<size_t> next{0};
+
+            size_t busy = 0;   // workers that have not finished the current job
+            size_t generation = 0;
+            bool stopping = false;
+            std::exception_ptr error;
+
+            static bool &inTask()
+            {
+                static thread_local bool in_task = false;
+                return in_task;
+            }
+
+            void work()
+            {
+                for(size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < parts;)
+                {
+                    try
+                    {
+                        call(context, i);
+                    }
+                    catch(...)
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        if(!error)
+                            error = std::current_exception();
+                    }
+                }
+            }
+
+            void loop()
+            {
+                inTask() = true;
+                size_t seen = 0;
+
+                std::unique_lock<std::mutex> guard(lock);
+                while(true)
+                {
+                    wake.wait(guard, [&] { return stopping || generation != seen; });
+                    if(stopping)
+                        return;
+
+                    seen = generation;
+                    guard.unlock();
+                    work();
+                    guard.lock();
+
+                    if(--busy == 0)
+                        done.notify_one();
+                }
+            }
+
+        public:
+            /**
+             * @brief ThreadPool
+             * @param threads Number of threads working on a job, including the calling thread
+             */
+            explicit ThreadPool(size_t threads = std::thread::hardware_concurrency())
+            {
+                for(size_t i = 1; i < threads; i++)
+                    workers.emplace_back([this] { loop(); });
+            }
+
+            ThreadPool(const ThreadPool &) = delete;
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+            ~ThreadPool()
+            {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    stopping = true;
+                }
+                wake.notify_all();
+
+                for(std::thread &t : workers)
+                    t.join();
+            }
+
+            /**
+             * @brief shared Pool with one thread per hardware thread, used when a Policy names no pool
+             * @return
+             */
+            static ThreadPool &shared()
+            {
+                static ThreadPool pool;
+                return pool;
+            }
+
+            /**
+             * @brief size
+             * @return Number of threads working on a job, including the calling thread
+             */
+            size_t size() const { return workers.size() + 1; }
+
+            /**
+             * @brief run Calls f(i) for every i in [0, n) and returns when all calls have returned
+             * The first exception thrown by a call is rethrown after the remaining calls have finished.
+             * @param n
+             * @param f
+             */
+            template <typename F>
+            void run(size_t n, F &&f)
+            {
+                if(n == 1 || workers.empty() || inTask())
+                {
+                    for(size_t i = 0; i < n; i++)
+                        f(i);
+                    return;
+                }
+
+                std::lock_guard<std::mutex> serial(submit);
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    call = [](void *c, size_t i) { (*static_cast<std::remove_reference_t<F>*>(c))(i); };
+                    context = const_cast<void*>(static_cast<const void*>(&f));
+                    parts = n;
+                    next.store(0, std::memory_order_relaxed);
+                    busy = workers.size();
+                    error = nullptr;
+                    generation++;
+                }
+                wake.notify_all();
+
+                inTask() = true;
+                work();
+                inTask() = false;
+
+                std::unique_lock<std::mutex> guard(lock);
+                done.wait(guard, [&] { return busy == 0; });
+
+                if(error)
+                    std::rethrow_exception(std::exchange(error, nullptr));
+            }
+        };
+
+        /**
+         * @brief Policy Where and from which size on a kernel runs in parallel
+         */
+        struct Policy
+        {
+            /**
+             * @brief pool Pool running the parts, ThreadPool::shared() if null
+             */
+            ThreadPool *pool = nullptr;
+
+            /**
+             * @brief threshold Least number of elements per part; shorter ranges run serially
+             */
+            size_t threshold = 1 << 15;
+
+            ThreadPool &threads() const { return pool ? *pool : ThreadPool::shared(); }
+
+            /**
+             * @brief partitions
+             * @param n Number of elements
+             * @return Number of parts to split n elements into
+             */
+            size_t partitions(size_t n) const
+            {
+                size_t parts = n / (threshold ? threshold : 1);
+                if(parts > threads().size())
+                    parts = threads().size();
+                return parts ? parts : 1;
+            }
+        };
+
+        /**
+         * @brief part Bounds of part i of n elements split into parts, which differ in size by at most one
+         */
+        inline size_t part(size_t n, size_t parts, size_t i) { return n / parts * i + (i < n % parts ? i : n % parts); }
+
+        /**
+         * @brief for_each Calls f on every element of [begin, end) in no particular order
+         * f is shared by all threads and must be safe to call concurrently.
+         */
+        template <typename T, typename F>
+        void for_each(T *begin, T *end, F &f, const Policy &policy = Policy())
+        {
+            size_t n = end - begin, parts = policy.partitions(n);
+            policy.threads().run(parts, [&](size_t i) { std::for_each(begin + part(n, parts, i), begin + part(n, parts, i + 1), std::ref(f)); });
+        }
+
+        /**
+         * @brief transform Stores f(begin[i]) in out[i] for every element of [begin, end)
+         */
+        template <typename T, typename U, typename F>
+        void transform(const T *begin, const T *end, U *out, F &f, const Policy &policy = Policy())
+        {
+            size_t n = end - begin, parts = policy.partitions(n);
+            policy.threads().run(parts, [&](size_t i) {
+                size_t from = part(n, parts, i);
+                std::transform(begin + from, begin + part(n, parts, i + 1), out + from, std::ref(f));
+            });
+        }
+
+        /**
+         * @brief reduce Folds [begin, end) into init with op, which must be associative but need not be commutative
+         * Every part starts from its first element converted to R, so op combines R with T as well as R with R.
+         * @param reversed Fold from the last element to the first
+         * @return init op e0 op e1 ..., in buffer order or in reverse
+         */
+        template <typename R, typename T, typename Op>
+        R reduce(const T *begin, const T *end, R init, Op &op, bool reversed, const Policy &policy = Policy())
+        {
+            size_t n = end - begin, parts = policy.partitions(n);
+
+            std::vector<std::optional<R>> partial(parts);
+            policy.threads().run(parts, [&](size_t i) {
+                const T *from = begin + part(n, parts, i), *to = begin + part(n, parts, i + 1);
+                if(from == to)
+                    return;
+
+                if(reversed)
+                {
+                    R acc(*--to);
+                    while(to != from)
+                        acc = op(std::move(acc), *--to);
+                    partial[i].emplace(std::move(acc));
+                }
+                else
+                {
+                    R acc(*from++);
+                    for(; from != to; from++)
+                        acc = op(std::move(acc), *from);
+                    partial[i].emplace(std::move(acc));
+                }
+            });
+
+            for(size_t i = 0; i < parts; i++)
+            {
+                std::optional<R> &p = partial[reversed ? parts - 1 - i : i];
+                if(p)
+                    init = op(std::move(init), std::move(*p));
+            }
+            return init;
+        }
+
+        /**
+         * @brief sort Sorts [begin, end) by comp; the parts are sorted concurrently and merged pairwise in rounds
+         */
+        template <typename T, typename Compare>
+        void sort(T *begin, T *end, Compare comp, const Policy &policy = Policy())
+        {
+            size_t n = end - begin, parts = policy.partitions(n);
+
+            ThreadPool &threads = policy.threads();
+            threads.run(parts, [&](size_t i) { std::sort(begin + part(n, parts, i), begin + part(n, parts, i + 1), comp); });
+
+            for(size_t width = 1; width < parts; width *= 2)
+            {
+                threads.run((parts + 2 * width - 1) / (2 * width), [&](size_t i) {
+                    size_t first = 2 * width * i, middle = first + width, last = std::min(first + 2 * width, parts);
+                    if(middle < last)
+                        std::inplace_merge(begin + part(n, parts, first), begin + part(n, parts, middle), begin + part(n, parts, last), comp);
+                });
+            }
+        }
+
+        /**
+         * @brief data First element of the buffer of a Stack or SoAColumn in memory order
+         * @return nullptr for an empty container, whose buffer must not be dereferenced
+         */
+        template <typename C>
+        auto data(C &c) -> decltype(&*c.buffer_begin()) { return c.size() ? &*c.buffer_begin() : nullptr; }
+
+        /**
+         * @brief transformed Maps the n elements from begin with f into a new Stack with the given direction
+         */
+        template <typename U, typename T, typename F>
+        Stack<U> transformed(const T *begin, size_t n, bool direction, F &f, const Policy &policy)
+        {
+            Stack<U> out(n);
+            for(size_t i = 0; i < n; i++)
+                out.push_top(U());
+            out.setDirection(direction);
+
+            transform(begin, begin + n, data(out), f, policy);
+            return out;
+        }
+
+        /**
+         * @brief for_each Calls f on every element of stack in no particular order, see for_each() over a range
+         */
+        template <typename T, typename F>
+        void for_each(Stack<T> &stack, F f, const Policy &policy = Policy()) { T *b = data(stack); for_each(b, b + stack.size(), f, policy); }
+
+        template <typename T, typename F>
+        void for_each(const SoAColumn<T> &column, F f, const Policy &policy = Policy()) { T *b = data(column); for_each(b, b + column.size(), f, policy); }
+
+        /**
+         * @brief transform Maps every element of stack with f
+         * @return Stack of the same direction whose element at index i is f of the element at index i
+         */
+        template <typename T, typename F, typename U = std::decay_t<std::invoke_result_t<F&, const T&>>>
+        Stack<U> transform(const Stack<T> &stack, F f, const Policy &policy = Policy())
+        {
+            return transformed<U>(data(stack), stack.size(), stack.getDirection(), f, policy);
+        }
+
+        template <typename T, typename F, typename U = std::decay_t<std::invoke_result_t<F&, const T&>>>
+        Stack<U> transform(const SoAColumn<T> &column, F f, const Policy &policy = Policy())
+        {
+            return transformed<U>(data(column), column.size(), column.getDirection(), f, policy);
+        }
+
+        /**
+         * @brief reduce Folds the elements of stack into init with op from the top to the bottom
+         * op must be associative but need not be commutative. R must be constructible from an element, op is called
+         * with R and T as well as with two R.
+         * @return init op top op ... op bottom
+         */
+        template <typename T, typename R, typename Op>
+        R reduce(const Stack<T> &stack, R init, Op op, const Policy &policy = Policy())
+        {
+            const T *b = data(stack);
+            return reduce(b, b + stack.size(), std::move(init), op, stack.getDirection(), policy);
+        }
+
+        template <typename T, typename R, typename Op>
+        R reduce(const SoAColumn<T> &column, R init, Op op, const Policy &policy = Policy())
+        {
+            const T *b = data(column);
+            return reduce(b, b + column.size(), std::move(init), op, column.getDirection(), policy);
+        }
+
+        /**
+         * @brief sort Sorts stack so that comp holds from the top to the bottom
+         */
+        template <typename T, typename Compare = std::less<T>>
+        void sort(Stack<T> &stack, Compare comp = Compare(), const Policy &policy = Policy())
+        {
+            T *b = data(stack);
+            if(stack.getDirection())
+                sort(b, b + stack.size(), [&comp](const T &x, const T &y) { return comp(y, x); }, policy);
+            else
+                sort(b, b + stack.size(), comp, policy);
+        }
+    }
+}
+
+#endif // PARALLEL_H
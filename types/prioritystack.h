@@ -0,0 +1,353 @@
+#ifndef PRIORITYSTACK_H
+#define PRIORITYSTACK_H
+
+#include "stack.h"
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * @brief PriorityStack D-ary heap kept in Stack storage, the top is the element Compare ranks highest
+     * As with std::priority_queue, the default std::less puts the largest element on top. Every element gets a
+     * handle when pushed, which stays valid until the element leaves the heap and allows changing its key in place.
+     * A 4-ary heap halves the depth of a binary one while the children of a node usually share a cache line.
+     * @tparam T
+     * @tparam Compare Strict weak ordering, Compare(a, b) is true if a ranks below b
+     * @tparam D Number of children per node, at least 2
+     */
+    template <typename T, typename Compare = std::less<T>, std::size_t D = 4>
+    class PriorityStack
+    {
+        static_assert(D >= 2, "PriorityStack needs at least two children per node");
+
+        static constexpr std::size_t npos = ~std::size_t(0);
+
+    public:
+        /**
+         * @brief Handle Identifies a pushed element until it is pulled
+         * Ids are reused, the generation tells a stale handle from the one of a later push that got the same id.
+         */
+        struct Handle
+        {
+            std::size_t id = npos;
+            std::size_t generation = 0;
+
+            bool operator ==(const Handle &other) const { return id == other.id && generation == other.generation; }
+            bool operator !=(const Handle &other) const { return !(*this == other); }
+        };
+
+    private:
+        Stack<T> heap;              // heap order in memory order, the root at buffer_begin()
+        Stack<std::size_t> owner;   // handle id of every heap slot
+        Stack<std::size_t> slot;    // heap slot of every handle id, npos for free ids
+        Stack<std::size_t> generations; // bumped whenever an id is freed
+        Stack<std::size_t> free_ids;
+
+        Compare comp;
+
+        T &value(std::size_t i) { return heap.buffer_begin()[i]; }
+        std::size_t &ownerOf(std::size_t i) { return owner.buffer_begin()[i]; }
+        std::size_t &slotOf(std::size_t id) { return slot.buffer_begin()[id]; }
+        std::size_t &generationOf(std::size_t id) { return generations.buffer_begin()[id]; }
+
+        void place(std::size_t i, T &&t, std::size_t id)
+        {
+            value(i) = std::move(t);
+            ownerOf(i) = id;
+            slotOf(id) = i;
+        }
+
+        void siftUp(std::size_t i)
+        {
+            T t = std::move(value(i));
+            std::size_t id = ownerOf(i);
+
+            while(i > 0)
+            {
+                std::size_t p = (i - 1) / D;
+                if(!comp(value(p), t))
+                    break;
+
+                place(i, std::move(value(p)), ownerOf(p));
+                i = p;
+            }
+
+            place(i, std::move(t), id);
+        }
+
+        void siftDown(std::size_t i)
+        {
+            std::size_t n = heap.size();
+            T t = std::move(value(i));
+            std::size_t id = ownerOf(i);
+
+            for(;;)
+            {
+                std::size_t first = D * i + 1;
+                if(first >= n)
+                    break;
+
+                std::size_t last = first + D < n ? first + D : n;
+                std::size_t best = first;
+                for(std::size_t c = first + 1; c < last; c++)
+                    if(comp(value(best), value(c)))
+                        best = c;
+
+                if(!comp(t, value(best)))
+                    break;
+
+                place(i, std::move(value(best)), ownerOf(best));
+                i = best;
+            }
+
+            place(i, std::move(t), id);
+        }
+
+        std::size_t newId()
+        {
+            if(free_ids.size())
+                return free_ids.pull_top();
+
+            slot.push_top(npos);
+            generations.push_top(0);
+            return slot.size() - 1;
+        }
+
+        /**
+         * @brief retire Frees id, which invalidates the handles carrying it
+         */
+        void retire(std::size_t id)
+        {
+            slotOf(id) = npos;
+            generationOf(id)++;
+            free_ids.push_top(id);
+        }
+
+        void removeSlot(std::size_t i)
+        {
+            std::size_t id = ownerOf(i);
+            std::size_t last = heap.size() - 1;
+
+            retire(id);
+
+            if(i != last)
+            {
+                place(i, std::move(value(last)), ownerOf(last));
+                heap.pop_top();
+                owner.pop_top();
+
+                if(i > 0 && comp(value((i - 1) / D), value(i)))
+                    siftUp(i);
+                else
+                    siftDown(i);
+            }
+            else
+            {
+                heap.pop_top();
+                owner.pop_top();
+            }
+        }
+
+    public:
+        /**
+         * @brief PriorityStack
+         * @param size Initial capacity
+         * @param comp
+         */
+        PriorityStack(std::size_t size = 8, Compare comp = Compare()) : heap(size), owner(size), slot(size), generations(size), comp(std::move(comp)) { }
+
+        /**
+         * @brief PriorityStack Takes over the buffer of stack and orders it in O(n), see heapify()
+         * @param stack
+         * @param comp
+         */
+        PriorityStack(Stack<T> &&stack, Compare comp = Compare()) : comp(std::move(comp)) { heapify(std::move(stack)); }
+
+        /**
+         * @brief heapify Replaces the contents with the elements of stack in O(n)
+         * The buffer of stack is reused, its elements get the ids 0 to size() - 1 in memory order. Handles of the
+         * previous contents are invalidated.
+         * @param stack
+         */
+        void heapify(Stack<T> &&stack)
+        {
+            heap = std::move(stack);
+            heap.setDirection(true);
+
+            std::size_t n = heap.size();
+            std::size_t ids = n > slot.size() ? n : slot.size();
+
+            for(std::size_t id = 0; id < generations.size(); id++)
+                generationOf(id)++;
+            while(generations.size() < ids)
+                generations.push_top(0);
+
+            owner = Stack<std::size_t>(n ? n : 8);
+            slot = Stack<std::size_t>(ids ? ids : 8);
+            free_ids.clear();
+
+            for(std::size_t i = 0; i < n; i++)
+                owner.push_top(i);
+            for(std::size_t id = 0; id < ids; id++)
+                slot.push_top(id < n ? id : npos);
+            for(std::size_t id = ids; id-- > n;)
+                free_ids.push_top(id);
+
+            for(std::size_t i = n > 1 ? (n - 2) / D + 1 : 0; i-- > 0;)
+                siftDown(i);
+        }
+
+        /**
+         * @brief push Adds t in O(log n)
+         * @param t
+         * @return Handle of the new element
+         */
+        Handle push(const T &t)
+        {
+            std::size_t id = newId();
+
+            heap.push_top(t);
+            owner.push_top(id);
+            slotOf(id) = heap.size() - 1;
+
+            siftUp(heap.size() - 1);
+            return Handle{id, generationOf(id)};
+        }
+
+        /**
+         * @brief top
+         * @return The highest ranked element
+         */
+        const T &top() const
+        {
+            if(!heap.size())
+                throw "PriorityStack is empty";
+
+            return *heap.buffer_begin();
+        }
+
+        /**
+         * @brief topHandle
+         * @return Handle of the highest ranked element
+         */
+        Handle topHandle() const
+        {
+            if(!heap.size())
+                throw "PriorityStack is empty";
+
+            std::size_t id = *owner.buffer_begin();
+            return Handle{id, *(generations.buffer_begin() + id)};
+        }
+
+        /**
+         * @brief pull_top Removes the highest ranked element in O(log n) and returns it
+         * @return
+         */
+        T pull_top()
+        {
+            if(!heap.size())
+                throw "PriorityStack is empty";
+
+            T t = std::move(value(0));
+            removeSlot(0);
+            return t;
+        }
+
+        /**
+         * @brief pop_top Removes the highest ranked element, if there is one
+         */
+        void pop_top() { if(heap.size()) removeSlot(0); }
+
+        /**
+         * @brief contains
+         * @param h
+         * @return true if the element of h is still in the heap
+         */
+        bool contains(Handle h) const
+        {
+            return h.id < slot.size() && *(slot.buffer_begin() + h.id) != npos && *(generations.buffer_begin() + h.id) == h.generation;
+        }
+
+        /**
+         * @brief get
+         * @param h
+         * @return The element of h
+         */
+        const T &get(Handle h) const
+        {
+            if(!contains(h))
+                throw "PriorityStack handle is not valid";
+
+            return heap.buffer_begin()[*(slot.buffer_begin() + h.id)];
+        }
+
+        /**
+         * @brief decrease_key Moves the element of h towards the top after raising its rank to t
+         * t must not rank below the current value, use update() otherwise.
+         * @param h
+         * @param t
+         */
+        void decrease_key(Handle h, const T &t)
+        {
+            if(!contains(h))
+                throw "PriorityStack handle is not valid";
+
+            std::size_t i = slotOf(h.id);
+            if(comp(t, value(i)))
+                throw "PriorityStack key was not decreased";
+
+            value(i) = t;
+            siftUp(i);
+        }
+
+        /**
+         * @brief update Replaces the element of h with t and restores the heap order in either direction
+         * @param h
+         * @param t
+         */
+        void update(Handle h, const T &t)
+        {
+            if(!contains(h))
+                throw "PriorityStack handle is not valid";
+
+            std::size_t i = slotOf(h.id);
+            bool raised = comp(value(i), t);
+
+            value(i) = t;
+            raised ? siftUp(i) : siftDown(i);
+        }
+
+        /**
+         * @brief erase Removes the element of h in O(log n)
+         * @param h
+         */
+        void erase(Handle h)
+        {
+            if(!contains(h))
+                throw "PriorityStack handle is not valid";
+
+            removeSlot(slotOf(h.id));
+        }
+
+        std::size_t size() const { return heap.size(); }
+        bool empty() const { return !heap.size(); }
+
+        /**
+         * @brief clear Removes all elements and invalidates all handles
+         */
+        void clear()
+        {
+            for(std::size_t id = 0; id < slot.size(); id++)
+                if(slotOf(id) != npos)
+                    retire(id);
+
+            heap.clear();
+            owner.clear();
+        }
+    };
+}
+
+#endif // PRIORITYSTACK_H
@@ -0,0 +1,280 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <type_traits>
+
+namespace Types
+{
+    /**
+     * Bulk kernels over contiguous ranges. Arithmetic element types use GCC/Clang vector extensions, 32 bytes wide when
+     * the target has AVX2 and 16 bytes (SSE/NEON) otherwise; other types and other compilers use the scalar loops.
+     * Floating point sums are accumulated per lane, so their rounding can differ from a sequential loop.
+     */
+    namespace Simd
+    {
+#if defined(__GNUC__)
+        template <typename T>
+        constexpr bool vectorizable = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                      (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+        template <typename T>
+        struct Vec
+        {
+#if defined(__AVX2__)
+            static constexpr size_t bytes = 32;
+#else
+            static constexpr size_t bytes = 16;
+#endif
+            static constexpr size_t lanes = bytes / sizeof(T);
+
+            typedef T type __attribute__((vector_size(bytes)));
+
+            static type load(const T *p) { type v; memcpy(&v, p, bytes); return v; }
+            static type splat(T t) { type v; for(size_t i = 0; i < lanes; i++) v[i] = t; return v; }
+
+            /**
+             * @brief bits Number of set bits in a comparison mask, lanes * 8 * sizeof(T) for all lanes true
+             */
+            template <typename M>
+            static size_t bits(M mask)
+            {
+                uint64_t w[bytes / 8];
+                memcpy(w, &mask, bytes);
+                size_t n = 0;
+                for(size_t i = 0; i < bytes / 8; i++)
+                    n += size_t(__builtin_popcountll(w[i]));
+                return n;
+            }
+        };
+#else
+        template <typename T>
+        constexpr bool vectorizable = false;
+#endif
+
+        /**
+         * @brief find_first
+         * @return Pointer to the first element in [begin, end) equal to val, or end
+         */
+        template <typename T>
+        const T *find_first(const T *begin, const T *end, const T &val)
+        {
+#if defined(__GNUC__)
+            if constexpr(vectorizable<T>)
+            {
+                typedef Vec<T> V;
+                typename V::type v = V::splat(val);
+                for(; begin + V::lanes <= end; begin += V::lanes)
+                    if(V::bits(V::load(begin) == v))
+                        break;
+            }
+#endif
+            for(; begin != end; begin++)
+                if(*begin == val)
+                    return begin;
+            return end;
+        }
+
+        /**
+         * @brief find_last
+         * @return Pointer to the last element in [begin, end) equal to val, or end
+         */
+        template <typename T>
+        const T *find_last(const T *begin, const T *end, const T &val)
+        {
+            const T *p = end;
+#if defined(__GNUC__)
+            if constexpr(vectorizable<T>)
+            {
+                typedef Vec<T> V;
+                typename V::type v = V::splat(val);
+                for(; size_t(p - begin) >= V::lanes; p -= V::lanes)
+                    if(V::bits(V::load(p - V::lanes) == v))
+                        break;
+            }
+#endif
+            while(p != begin)
+                if(*--p == val)
+                    return p;
+            return end;
+        }
+
+        /**
+         * @brief count
+         * @return Number of elements in [begin, end) equal to val
+         */
+        template <typename T>
+        size_t count(const T *begin, const T *end, const T &val)
+        {
+            size_t n = 0;
+#if defined(__GNUC__)
+            if constexpr(vectorizable<T>)
+            {
+                typedef Vec<T> V;
+                typename V::type v = V::splat(val);
+                size_t set = 0;
+                for(; begin + V::lanes <= end; begin += V::lanes)
+                    set += V::bits(V::load(begin) == v);
+                n = set / (8 * sizeof(T));
+            }
+#endif
+            for(; begin != end; begin++)
+                n += *begin == val;
+            return n;
+        }
+
+        /**
+         * @brief sum
+         * @return Sum of the elements in [begin, end) accumulated in T
+         */
+        template <typename T>
+        T sum(const T *begin, const T *end)
+        {
+            T s = T();
+#if defined(__GNUC__)
+            if constexpr(vectorizable<T>)
+            {
+                typedef Vec<T> V;
+                typename V::type acc = V::splat(T());
+                for(; begin + V::lanes <= end; begin += V::lanes)
+                    acc += V::load(begin);
+                for(size_t i = 0; i < V::lanes; i++)
+                    s += acc[i];
+            }
+#endif
+            for(; begin != end; begin++)
+                s += *begin;
+            return s;
+        }
+
+        /**
+         * @brief min Requires a non-empty range, NaN elements are skipped
+         * @return The smallest element of [begin, end), NaN only if every element is NaN
+         */
+        template <typename T>
+        T min(const T *begin, const T *end)
+        {
+            T m = *begin;
+#if defined(__GNUC__)
+            if constexpr(vectorizable<T>)
+            {
+                typedef Vec<T> V;
+                if(begin + V::lanes <= end)
+                {
+                    typename V::type acc = V::load(begin);
+                    for(begin += V::lanes; begin + V::lanes <= end; begin += V::lanes)
+                    {
+                        typename V::type v = V::load(begin);
+                        acc = (v < acc) | (acc != acc) ? v : acc;
+                    }
+                    for(size_t i = 0; i < V::lanes; i++)
+                        if(acc[i] < m || m != m)
+                            m = acc[i];
+                }
+            }
+#endif
+            for(; begin != end; begin++)
+                if(*begin < m || m != m)
+                    m = *begin;
+            return m;
+        }
+
+        /**
+         * @brief max Requires a non-empty range, NaN elements are skipped
+         * @return The largest element of [begin, end), NaN only if every element is NaN
+         */
+        template <typename T>
+        T max(const T *begin, const T *end)
+        {
+            T m = *begin;
+#if defined(__GNUC__)
+            if constexpr(vectorizable<T>)
+            {
+                typedef Vec<T> V;
+                if(begin + V::lanes <= end)
+                {
+                    typename V::type acc = V::load(begin);
+                    for(begin += V::lanes; begin + V::lanes <= end; begin += V::lanes)
+                    {
+                        typename V::type v = V::load(begin);
+                        acc = (v > acc) | (acc != acc) ? v : acc;
+                    }
+                    for(size_t i = 0; i < V::lanes; i++)
+                        if(acc[i] > m || m != m)
+                            m = acc[i];
+                }
+            }
+#endif
+            for(; begin != end; begin++)
+                if(*begin > m || m != m)
+                    m = *begin;
+            return m;
+        }
+
+        /**
+         * @brief equal
+         * @return true if a[i] == b[i] for every i < n (elements compared with !=)
+         */
+        template <typename T>
+        bool equal(const T *a, const T *b, size_t n)
+        {
+            size_t i = 0;
+#if defined(__GNUC__)
+            if constexpr(vectorizable<T>)
+            {
+                typedef Vec<T> V;
+                for(; i + V::lanes <= n; i += V::lanes)
+                    if(V::bits(V::load(a + i) != V::load(b + i)))
+                        return false;
+            }
+#endif
+            for(; i < n; i++)
+                if(a[i] != b[i])
+                    return false;
+            return true;
+        }
+
+        /**
+         * @brief equal_reversed
+         * @return true if a[i] == b[n - 1 - i] for every i < n (elements compared with !=)
+         */
+        template <typename T>
+        bool equal_reversed(const T *a, const T *b, size_t n)
+        {
+            size_t i = 0;
+#if defined(__GNUC__)
+            if constexpr(vectorizable<T>)
+            {
+                typedef Vec<T> V;
+                for(; i + V::lanes <= n; i += V::lanes)
+                {
+                    typename V::type va = V::load(a + i), vb = V::load(b + n - i - V::lanes), rb;
+                    for(size_t l = 0; l < V::lanes; l++)
+                        rb[l] = vb[V::lanes - 1 - l];
+                    if(V::bits(va != rb))
+                        return false;
+                }
+            }
+#endif
+            for(; i < n; i++)
+                if(a[i] != b[n - 1 - i])
+                    return false;
+            return true;
+        }
+
+        /**
+         * @brief fill Assigns val to every element of [begin, end)
+         */
+        template <typename T>
+        void fill(T *begin, T *end, const T &val)
+        {
+            for(; begin != end; begin++)
+                *begin = val;
+        }
+    }
+}
+
+#endif // SIMD_H
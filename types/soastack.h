@@ -0,0 +1,271 @@
+#ifndef SOASTACK_H
+#define SOASTACK_H
+
+#include "stack.h"
+
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * @brief SoAColumn View of one column of a SoAStack
+     * Gives access to the elements and to the bulk operations of the Stack holding the column, but not to pushes, pops,
+     * direction changes or sorting, which would break the record alignment. view() offers the whole read-only Stack API.
+     * @tparam T Type of the field, const for the read-only columns of a const SoAStack
+     */
+    template <typename T>
+    class SoAColumn
+    {
+        using Field = std::remove_const_t<T>;
+        using StackType = std::conditional_t<std::is_const<T>::value, const Stack<Field>, Stack<Field>>;
+
+        StackType *stack;
+
+    public:
+        explicit SoAColumn(StackType &stack) : stack(&stack) { }
+
+        /**
+         * @brief view Read-only access to the whole Stack API of the column
+         * @return
+         */
+        const Stack<Field> &view() const { return *stack; }
+
+        T &operator[](std::size_t idx) const { return (*stack)[idx]; }
+
+        std::size_t size() const { return stack->size(); }
+        bool empty() const { return !stack->size(); }
+        bool getDirection() const { return stack->getDirection(); }
+
+        DirectionalIterator<T> begin() const { return stack->begin(); }
+        DirectionalIterator<T> end()   const { return stack->end(); }
+
+        ContiguousIterator<T> buffer_begin() const { return stack->buffer_begin(); }
+        ContiguousIterator<T> buffer_end()   const { return stack->buffer_end(); }
+
+        StridedView<T> strided(std::size_t stride, std::size_t offset = 0) const { return stack->strided(stride, offset); }
+        ChunkView<T> chunks(std::size_t n) const { return stack->chunks(n); }
+
+        DirectionalIterator<T> find(const Field &val) const { return stack->find(val); }
+        std::size_t count(const Field &val) const { return stack->count(val); }
+        Field sum() const { return stack->sum(); }
+        Field min() const { return stack->min(); }
+        Field max() const { return stack->max(); }
+
+        void fill(const Field &val) const
+        {
+            static_assert(!std::is_const<T>::value, "Columns of a const SoAStack are read-only");
+            stack->fill(val);
+        }
+    };
+
+    /**
+     * @brief SoAStack Stack of records stored as one Stack per field
+     * All columns see the same pushes and pops, so they grow and slide together and an index refers to the same
+     * record in every column. Passes over a single field walk only that field's buffer, for example with
+     * column<I>().sum() or column<I>().buffer_begin(); whole records are accessed through tuples of references.
+     * @tparam Fields Types of the fields of a record
+     */
+    template <typename... Fields>
+    class SoAStack
+    {
+        static_assert(sizeof...(Fields) > 0, "SoAStack needs at least one field");
+
+        std::tuple<Stack<Fields>...> columns;
+
+        template <typename F, std::size_t... I>
+        void forEachColumn(F &&f, std::index_sequence<I...>) { (f(std::get<I>(columns)), ...); }
+
+        template <typename F>
+        void forEachColumn(F &&f) { forEachColumn(std::forward<F>(f), std::index_sequence_for<Fields...>()); }
+
+        template <std::size_t... I>
+        std::tuple<Fields&...> at(std::size_t idx, std::index_sequence<I...>) const { return std::tuple<Fields&...>(std::get<I>(columns).begin()[idx]...); }
+
+        /**
+         * @brief pushTop Pushes the fields of record column by column and pops the pushed ones again if a push throws
+         */
+        template <std::size_t... I>
+        void pushTop(const std::tuple<const Fields&...> &record, std::index_sequence<I...>)
+        {
+            std::size_t pushed = 0;
+            try
+            {
+                ((std::get<I>(columns).push_top(std::get<I>(record)), pushed++), ...);
+            }
+            catch(...)
+            {
+                forEachColumn([&pushed](auto &c) { if(pushed) { c.pop_top(); pushed--; } });
+                throw;
+            }
+        }
+
+        template <std::size_t... I>
+        void pushBottom(const std::tuple<const Fields&...> &record, std::index_sequence<I...>)
+        {
+            std::size_t pushed = 0;
+            try
+            {
+                ((std::get<I>(columns).push_bottom(std::get<I>(record)), pushed++), ...);
+            }
+            catch(...)
+            {
+                forEachColumn([&pushed](auto &c) { if(pushed) { c.pop_bottom(); pushed--; } });
+                throw;
+            }
+        }
+
+    public:
+        using value_type = std::tuple<Fields...>;
+        using reference  = std::tuple<Fields&...>;
+
+        /**
+         * @brief Iterator Random access iterator from the top to the bottom yielding tuples of references
+         */
+        class Iterator
+        {
+            const SoAStack<Fields...> *stack = nullptr;
+            std::ptrdiff_t idx = 0;
+
+        public:
+            using iterator_concept  = std::random_access_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type        = SoAStack<Fields...>::value_type;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = SoAStack<Fields...>::reference;
+
+            Iterator() = default;
+            Iterator(const SoAStack<Fields...> *stack, std::ptrdiff_t idx) : stack(stack), idx(idx) { }
+
+            Iterator &operator ++() { idx++; return *this; }
+            Iterator &operator --() { idx--; return *this; }
+
+            Iterator operator ++(int) { Iterator copy(*this); idx++; return copy; }
+            Iterator operator --(int) { Iterator copy(*this); idx--; return copy; }
+
+            bool operator ==(const Iterator &other) const { return idx == other.idx; }
+            bool operator !=(const Iterator &other) const { return idx != other.idx; }
+            bool operator  <(const Iterator &other) const { return idx <  other.idx; }
+            bool operator  >(const Iterator &other) const { return idx >  other.idx; }
+            bool operator <=(const Iterator &other) const { return idx <= other.idx; }
+            bool operator >=(const Iterator &other) const { return idx >= other.idx; }
+
+            Iterator &operator +=(difference_type add) { idx += add; return *this; }
+            Iterator &operator -=(difference_type sub) { idx -= sub; return *this; }
+
+            Iterator operator +(difference_type add) const { return Iterator(stack, idx + add); }
+            Iterator operator -(difference_type sub) const { return Iterator(stack, idx - sub); }
+
+            friend Iterator operator +(difference_type add, const Iterator &it) { return it + add; }
+
+            difference_type operator -(const Iterator &sub) const { return idx - sub.idx; }
+
+            reference operator[](difference_type i) const { return stack->at(std::size_t(idx + i), std::index_sequence_for<Fields...>()); }
+            reference operator *() const { return stack->at(std::size_t(idx), std::index_sequence_for<Fields...>()); }
+        };
+
+        /**
+         * @brief SoAStack
+         * @param size Optional argument to set the initial amount of records every column holds
+         */
+        SoAStack(std::size_t size = 8) : columns(Stack<Fields>(size)...) { }
+
+        /**
+         * @brief column Access one field of every record
+         * @return A SoAColumn, which allows modifying elements but not pushing or popping a single column; the const
+         * overload returns a read-only SoAColumn
+         */
+        template <std::size_t I>
+        auto column() { return SoAColumn<std::tuple_element_t<I, std::tuple<Fields...>>>(std::get<I>(columns)); }
+
+        template <std::size_t I>
+        auto column() const { return SoAColumn<const std::tuple_element_t<I, std::tuple<Fields...>>>(std::get<I>(columns)); }
+
+        /**
+         * @brief push_top Pushes a record on the top of the stack
+         */
+        void push_top(const Fields &...fields) { pushTop(std::tuple<const Fields&...>(fields...), std::index_sequence_for<Fields...>()); }
+        void push_top(const value_type &record) { std::apply([this](const Fields &...fields) { push_top(fields...); }, record); }
+
+        /**
+         * @brief push_bottom Pushes a record on the bottom of the stack
+         */
+        void push_bottom(const Fields &...fields) { pushBottom(std::tuple<const Fields&...>(fields...), std::index_sequence_for<Fields...>()); }
+        void push_bottom(const value_type &record) { std::apply([this](const Fields &...fields) { push_bottom(fields...); }, record); }
+
+        void pop_top()    { forEachColumn([](auto &c) { c.pop_top(); }); }
+        void pop_bottom() { forEachColumn([](auto &c) { c.pop_bottom(); }); }
+
+        /**
+         * @brief pull_top Returns the record at the top of the stack and deletes it
+         * @return
+         */
+        value_type pull_top()
+        {
+            if(!size())
+                throw "SoAStack is empty";
+
+            value_type record = (*this)[0];
+            pop_top();
+            return record;
+        }
+
+        /**
+         * @brief pull_bottom Returns the record at the bottom of the stack and deletes it
+         * @return
+         */
+        value_type pull_bottom()
+        {
+            if(!size())
+                throw "SoAStack is empty";
+
+            value_type record = (*this)[size() - 1];
+            pop_bottom();
+            return record;
+        }
+
+        /**
+         * @brief operator [] Access record by index from the top
+         * @param idx
+         * @return Tuple of references to the fields of the record
+         */
+        reference operator[](std::size_t idx) const
+        {
+            if(idx >= size())
+                throw "Stack index out of bounds";
+
+            return at(idx, std::index_sequence_for<Fields...>());
+        }
+
+        std::size_t size() const { return std::get<0>(columns).size(); }
+        bool empty() const { return !size(); }
+
+        void clear() { forEachColumn([](auto &c) { c.clear(); }); }
+
+        Iterator begin() const { return Iterator(this, 0); }
+        Iterator end()   const { return Iterator(this, std::ptrdiff_t(size())); }
+
+        /**
+         * @brief getDirection Get the direction of the stack
+         * @return true for forward, false for backward
+         */
+        bool getDirection() const { return std::get<0>(columns).getDirection(); }
+
+        /**
+         * @brief setDirection Set the direction of the stack
+         * @param dir forward, false for backward
+         */
+        void setDirection(bool dir) { forEachColumn([dir](auto &c) { c.setDirection(dir); }); }
+
+        /**
+         * @brief reverse Reverses the direction of the stack
+         */
+        void reverse() { forEachColumn([](auto &c) { c.reverse(); }); }
+    };
+}
+
+#endif // SOASTACK_H
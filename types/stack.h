@@ -2,25 +2,169 @@
 #define STACK_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <type_traits>
 #include <utility>
 
+// snapshots and file mapped stacks need POSIX and are only compiled in when TYPES_ENABLE_MAPPED is defined
+#ifdef TYPES_ENABLE_MAPPED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "bufferviews.h"
 #include "directionaliterator.h"
+#include "simd.h"
+#include "stats.h"
+
+#ifdef __cpp_impl_coroutine
+#include "generator.h"
+#endif
 
 namespace Types
 {
     template <typename T>
     class Stack
     {
+        template <typename> friend class Stack;
+
         size_t size_real = 0;
 
         T *real_begin = 0;
-        T *data_begin, *data_end;
+        T *data_begin = 0, *data_end = 0;
 
         /**
          * @brief direction Direction of the stack; true for forward, false for backward
          */
         bool direction = true;
 
+#ifdef TYPES_ENABLE_STATS
+        StackStats stats_data;
+#endif
+
+#ifdef TYPES_ENABLE_MAPPED
+        /**
+         * @brief map_fd File backing the buffer of a stack created with mapped(), -1 for heap allocated stacks
+         */
+        int map_fd = -1;
+
+        /**
+         * @brief SnapshotHeader Precedes the elements written by save()
+         */
+        struct SnapshotHeader
+        {
+            char     magic[8];
+            uint64_t element_size;
+            uint64_t count;
+            uint64_t direction;
+        };
+
+        /**
+         * @brief MappedHeader First page of the file of a mapped() stack, the buffer follows it
+         */
+        struct MappedHeader
+        {
+            char     magic[8];
+            uint64_t element_size;
+            uint64_t capacity;
+            uint64_t begin;
+            uint64_t end;
+            uint64_t direction;
+        };
+
+        static constexpr size_t mapped_header_size = 4096;
+
+        char *map_base() const { return reinterpret_cast<char*>(real_begin) - mapped_header_size; }
+        size_t map_length() const { return mapped_header_size + size_real * sizeof(T); }
+
+        /**
+         * @brief write_mapped_header Records the live range and direction in the header page of a mapped stack
+         */
+        void write_mapped_header() const
+        {
+            MappedHeader h = { { 'A', 'U', 'T', 'M', 'S', 'T', 'K', '1' }, sizeof(T), size_real,
+                               uint64_t(data_begin - real_begin), uint64_t(data_end - real_begin), direction };
+            memcpy(map_base(), &h, sizeof(h));
+        }
+
+        /**
+         * @brief resize_mapped Grows the file and the mapping of a mapped stack in place of resize()
+         * Elements only move when there is no room left in front of them.
+         * @param new_size
+         * @return Number of bytes moved
+         */
+        size_t resize_mapped(size_t new_size)
+        {
+            size_t o_size = size();
+            size_t o_offset = data_begin - real_begin;
+            size_t o_length = map_length();
+
+            size_real = 2 * new_size;
+            if(ftruncate(map_fd, map_length()) < 0)
+                throw "Stack mapping could not be grown";
+
+#ifdef MREMAP_MAYMOVE
+            void *base = mremap(map_base(), o_length, map_length(), MREMAP_MAYMOVE);
+#else
+            munmap(map_base(), o_length);
+            void *base = mmap(nullptr, map_length(), PROT_READ | PROT_WRITE, MAP_SHARED, map_fd, 0);
+#endif
+            if(base == MAP_FAILED)
+                throw "Stack mapping could not be grown";
+
+            real_begin = reinterpret_cast<T*>(static_cast<char*>(base) + mapped_header_size);
+
+            size_t offset = o_offset ? o_offset : new_size / 2;
+
+            // only trivially copyable stacks can be mapped, the guard keeps others from instantiating the memmove
+            if constexpr(std::is_trivially_copyable<T>::value)
+                if(offset != o_offset)
+                    memmove(real_begin + offset, real_begin + o_offset, o_size * sizeof(T));
+
+            data_begin = real_begin + offset;
+            data_end = data_begin + o_size;
+
+            return offset != o_offset ? o_size * sizeof(T) : 0;
+        }
+#endif
+
+        /**
+         * @brief recenter Moves the elements to the middle of the buffer without reallocating
+         * Stacks used as queues drift towards one end of the buffer; while at most half of it is in use, sliding the
+         * elements back leaves room on both sides for at least size() / 2 more pushes, which keeps pushes amortized O(1).
+         */
+        void recenter()
+        {
+            size_t n = size();
+            T *target = real_begin + (size_real - n) / 2;
+
+            if(target < data_begin)
+                std::move(data_begin, data_end, target);
+            else if(target > data_begin)
+                std::move_backward(data_begin, data_end, target + n);
+
+            data_begin = target;
+            data_end = target + n;
+        }
+
+        /**
+         * @brief grow Makes room for one more element at an end of the buffer
+         * Recentering only helps with at least two free slots, one of which ends up on each side.
+         */
+        void grow()
+        {
+            if(size_real - size() >= 2 && 2 * size() <= size_real)
+                recenter();
+            else
+                resize(size_real ? size_real * 2 : 8);
+        }
+
         /**
          * @brief push_back_i Pushes val to to place behind data_end, resizes if needed
          * @param val
@@ -28,9 +172,16 @@ namespace Types
         void push_back_i(const T &val)
         {
             if(data_end >= real_begin + size_real)
-                resize(size_real * 2);
+                grow();
+
+            // the slot only joins the elements once the assignment succeeded
+            *data_end = val;
+            data_end++;
 
-            *data_end++ = val;
+#ifdef TYPES_ENABLE_STATS
+            if(size() > stats_data.peak_size)
+                stats_data.peak_size = size();
+#endif
         }
 
         /**
@@ -40,22 +191,38 @@ namespace Types
         void push_front_i(const T &val)
         {
             if(data_begin <= real_begin)
-                resize(size_real * 2);
+                grow();
+
+            *(data_begin - 1) = val;
+            data_begin--;
 
-            *(--data_begin) = val;
+#ifdef TYPES_ENABLE_STATS
+            if(size() > stats_data.peak_size)
+                stats_data.peak_size = size();
+#endif
+        }
+
+        /**
+         * @brief discard Releases what a popped slot owns; the slot stays a live object of the buffer allocated with new[]
+         * @param slot
+         */
+        static void discard(T &slot)
+        {
+            if constexpr(!std::is_trivially_destructible<T>::value)
+                slot = T();
         }
 
         /**
          * @brief push_back_i Pushes val to to place behind data_end, resizes if needed
          * @param val
          */
-        void pop_back_i() { (--data_end)->~T(); }
+        void pop_back_i() { discard(*--data_end); }
 
         /**
          * @brief push_back_i Pushes val to to place preceding data_begin, resizes if needed
          * @param val
          */
-        void pop_front_i() { data_begin->~T(); data_begin++; }
+        void pop_front_i() { discard(*data_begin++); }
 
         /**
          * @brief init
@@ -69,23 +236,67 @@ namespace Types
             data_begin = data_end = real_begin + buffer;
         }
 
+        /**
+         * @brief release Frees the buffer, or unmaps and closes the file of a mapped stack, and leaves no buffer behind
+         * Used instead of calling the destructor explicitly, which would end the lifetime of the object.
+         */
+        void release()
+        {
+#ifdef TYPES_ENABLE_MAPPED
+            if(map_fd >= 0)
+            {
+                if(real_begin)
+                {
+                    write_mapped_header();
+                    munmap(map_base(), map_length());
+                }
+                close(map_fd);
+                map_fd = -1;
+            }
+            else
+#endif
+            if(real_begin)
+                delete[] real_begin;
+            real_begin = data_begin = data_end = nullptr;
+        }
+
         /**
          * @brief resize Resizes the stack to a new size to fit more elements
          * @param new_size
          */
         void resize(size_t new_size)
         {
-            T* o_real_begin = real_begin;
-            T* o_data_begin = data_begin;
-            size_t o_size = size();
+            size_t o_capacity = size_real;
+            size_t relocated;
+
+#ifdef TYPES_ENABLE_MAPPED
+            if(map_fd >= 0)
+                relocated = resize_mapped(new_size);
+            else
+#endif
+            {
+                T* o_real_begin = real_begin;
+                T* o_data_begin = data_begin;
+                size_t o_size = size();
 
-            init(new_size, new_size / 2);
+                init(new_size, new_size / 2);
 
-            for(size_t i = 0; i < o_size; i++)
-                data_begin[i] = std::move(o_data_begin[i]);
-            data_end += o_size;
+                for(size_t i = 0; i < o_size; i++)
+                    data_begin[i] = std::move(o_data_begin[i]);
+                data_end += o_size;
 
-            delete o_real_begin;
+                delete[] o_real_begin;
+                relocated = o_size * sizeof(T);
+            }
+
+#ifdef TYPES_ENABLE_STATS
+            stats_data.resizes++;
+            stats_data.bytes_relocated += relocated;
+            if(stats_observer)
+                stats_observer->stackResized(this, o_capacity, size_real, relocated);
+#else
+            (void)o_capacity; (void)relocated;
+#endif
         }
 
     public:
@@ -128,16 +339,7 @@ namespace Types
             this->direction = direction;
         }
 
-        ~Stack()
-        {
-            if(real_begin)
-            {
-                for(T &e : *this)
-                    e.~T();
-                delete[] real_begin;
-            }
-            real_begin = data_begin = data_end = nullptr;
-        }
+        ~Stack() { release(); }
 
         /**
          * @brief operator = Copy operator
@@ -146,14 +348,19 @@ namespace Types
          */
         Stack<T> &operator=(const Stack<T> &other)
         {
-            this->~Stack<T>();
+            if(this == &other)
+                return *this;
+
+            release();
 
             init(other.size(), other.size() / 2);
 
             for(size_t i = 0; i < other.size(); i++)
-                data_begin[i] = std::move(other.rbegin()[i]);
+                data_begin[i] = other.data_begin[i];
             data_end += other.size();
 
+            direction = other.direction;
+
             return *this;
         }
 
@@ -164,52 +371,115 @@ namespace Types
          */
         Stack<T> &operator=(Stack<T> &&other)
         {
+            if(this == &other)
+                return *this;
+
+            release();
+
             real_begin = other.real_begin;
             data_begin = other.data_begin;
             data_end   = other.data_end;
             size_real  = other.size_real;
             direction  = other.direction;
+#ifdef TYPES_ENABLE_STATS
+            stats_data = other.stats_data;
+#endif
 
             other.real_begin = other.data_begin = other.data_end = nullptr;
-            other.~Stack<T>();
+            other.size_real = 0;
+
+#ifdef TYPES_ENABLE_MAPPED
+            map_fd = other.map_fd;
+            other.map_fd = -1;
+#endif
 
             return *this;
         }
 
         /**
-         * @brief operator ==
+         * @brief equals Compares the buffers directly, vectorized for arithmetic types
          * @param other
          * @return true if both stacks contain the same elements in the same order (compared with !=)
          */
-        bool operator ==(const Stack<T> &other) const
+        bool equals(const Stack<T> &other) const
         {
             if(other.size() != size())
                 return false;
 
-            for(int i = 0; i < size(); i++)
-                if((*this)[i] != other[i])
-                    return false;
-
-            return true;
+            if(direction == other.direction)
+                return Simd::equal(data_begin, other.data_begin, size());
+            else
+                return Simd::equal_reversed(data_begin, other.data_begin, size());
         }
 
+        /**
+         * @brief operator ==
+         * @param other
+         * @return true if both stacks contain the same elements in the same order (compared with !=)
+         */
+        bool operator ==(const Stack<T> &other) const { return equals(other); }
+
         /**
          * @brief operator !=
          * @param other
          * @return false if both stacks contain the same elements in the same order (compared with ==)
          */
-        bool operator !=(const Stack<T> &other) const
+        bool operator !=(const Stack<T> &other) const { return !equals(other); }
+
+        /**
+         * @brief find Searches from the top of the stack, vectorized for arithmetic types
+         * @param val
+         * @return Iterator to the topmost element equal to val or end()
+         */
+        DirectionalIterator<T> find(const T &val) const
         {
-            if(other.size() != size())
-                return true;
+            const T *p = direction ? Simd::find_last(data_begin, data_end, val) : Simd::find_first(data_begin, data_end, val);
+            return p == data_end ? end() : DirectionalIterator<T>(const_cast<T*>(p), !direction);
+        }
+
+        /**
+         * @brief count
+         * @param val
+         * @return Number of elements equal to val
+         */
+        size_t count(const T &val) const { return Simd::count(data_begin, data_end, val); }
+
+        /**
+         * @brief sum
+         * @return Sum of all elements, T() for an empty stack
+         */
+        T sum() const { return Simd::sum(data_begin, data_end); }
+
+        /**
+         * @brief min NaN elements are skipped
+         * @return The smallest element, NaN only if every element is NaN
+         */
+        T min() const
+        {
+            if(!size())
+                throw "Stack is empty";
 
-            for(int i = 0; i < size(); i++)
-                if((*this)[i] != other[i])
-                    return true;
+            return Simd::min(data_begin, data_end);
+        }
 
-            return false;
+        /**
+         * @brief max NaN elements are skipped
+         * @return The largest element, NaN only if every element is NaN
+         */
+        T max() const
+        {
+            if(!size())
+                throw "Stack is empty";
+
+            return Simd::max(data_begin, data_end);
         }
 
+        /**
+         * @brief fill Assigns val to every element
+         * @param val
+         */
+        void fill(const T &val) { Simd::fill(data_begin, data_end, val); }
+
         /**
          * @brief operator += Pushes add on top of the stack
          * @param add
@@ -248,20 +518,243 @@ namespace Types
             return data_end - data_begin;
         }
 
+        /**
+         * @brief stats
+         * @return Statistics of the stack; resizes, bytes_relocated and the peak of pushes are only counted with TYPES_ENABLE_STATS
+         */
+        StackStats stats() const
+        {
+            StackStats s;
+#ifdef TYPES_ENABLE_STATS
+            s = stats_data;
+#endif
+            s.size = size();
+            s.capacity = size_real;
+            if(s.peak_size < s.size)
+                s.peak_size = s.size;
+            return s;
+        }
+
         /**
          * @brief clear Clears the stack
          */
         void clear()
         {
-            this->~Stack<T>();
+#ifdef TYPES_ENABLE_MAPPED
+            if(map_fd >= 0)
+            {
+                data_begin = data_end = real_begin + size_real / 2;
+                return;
+            }
+#endif
+
+            release();
             init();
         }
 
+#ifdef TYPES_ENABLE_MAPPED
+        /**
+         * @brief save Writes the elements and the direction of the stack to fd, with a single write unless it is cut short
+         * @param fd
+         */
+        void save(int fd) const
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Stack::save requires trivially copyable elements");
+
+            SnapshotHeader h = { { 'A', 'U', 'T', 'S', 'S', 'T', 'K', '1' }, sizeof(T), size(), direction };
+
+            iovec parts[2] = { { &h, sizeof(h) }, { data_begin, size() * sizeof(T) } };
+            iovec *part = parts;
+            int count = 2;
+
+            // a single write is capped (about 2 GiB on Linux), continue after partial writes
+            while(count)
+            {
+                ssize_t w = writev(fd, part, count);
+                if(w <= 0)
+                    throw "Stack could not be saved";
+
+                size_t written = size_t(w);
+                while(count && written >= part->iov_len)
+                {
+                    written -= part->iov_len;
+                    part++;
+                    count--;
+                }
+                if(count)
+                {
+                    part->iov_base = static_cast<char*>(part->iov_base) + written;
+                    part->iov_len -= written;
+                }
+            }
+        }
+
+        /**
+         * @brief load Replaces the contents of the stack with a snapshot written by save()
+         * @param fd
+         */
+        void load(int fd)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Stack::load requires trivially copyable elements");
+
+            SnapshotHeader h;
+            if(read(fd, &h, sizeof(h)) != ssize_t(sizeof(h)) || memcmp(h.magic, "AUTSSTK1", 8) != 0 || h.element_size != sizeof(T))
+                throw "Stack snapshot is invalid";
+
+            size_t count = h.count;
+            if(map_fd >= 0)
+            {
+                clear();
+                if(count > size_real)
+                    resize_mapped(count);
+                data_begin = real_begin + (size_real - count) / 2;
+            }
+            else
+            {
+                release();
+                init(count ? count : 8, count / 2);
+            }
+            data_end = data_begin;
+
+            char *dst = reinterpret_cast<char*>(data_begin);
+            size_t left = count * sizeof(T);
+            while(left)
+            {
+                ssize_t r = read(fd, dst, left);
+                if(r <= 0)
+                    throw "Stack snapshot is truncated";
+                dst += r;
+                left -= size_t(r);
+            }
+
+            data_end = data_begin + count;
+            direction = h.direction;
+        }
+
+        /**
+         * @brief mapped Opens or creates a stack whose buffer is a shared mapping of the file at path
+         * An existing file is reopened without reading it. Growing extends the file and the mapping with mremap.
+         * The live range and the direction are written to the file by sync() and on destruction.
+         * Assigning another stack to a mapped stack detaches it from the file.
+         * @param path
+         * @param size Initial amount of elements to hold when the file is created
+         * @return
+         */
+        static Stack<T> mapped(const std::string &path, size_t size = 8)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Stack::mapped requires trivially copyable elements");
+
+            Stack<T> stack(0, 0);
+            delete[] stack.real_begin;
+            stack.real_begin = stack.data_begin = stack.data_end = nullptr;
+
+            stack.map_fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if(stack.map_fd < 0)
+                throw "Stack file could not be opened";
+
+            struct stat st;
+            if(fstat(stack.map_fd, &st) < 0)
+                throw "Stack file could not be opened";
+
+            MappedHeader h;
+            bool created = st.st_size == 0;
+            if(created)
+            {
+                stack.size_real = 2 * (size ? size : 1);
+                if(ftruncate(stack.map_fd, mapped_header_size + stack.size_real * sizeof(T)) < 0)
+                    throw "Stack file could not be created";
+            }
+            else
+            {
+                if(size_t(st.st_size) < mapped_header_size || pread(stack.map_fd, &h, sizeof(h), 0) != ssize_t(sizeof(h)) ||
+                   memcmp(h.magic, "AUTMSTK1", 8) != 0 || h.element_size != sizeof(T) ||
+                   mapped_header_size + h.capacity * sizeof(T) > size_t(st.st_size) || h.begin > h.end || h.end > h.capacity)
+                    throw "Stack file is invalid";
+
+                stack.size_real = h.capacity;
+            }
+
+            void *base = mmap(nullptr, mapped_header_size + stack.size_real * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, stack.map_fd, 0);
+            if(base == MAP_FAILED)
+                throw "Stack file could not be mapped";
+
+            stack.real_begin = reinterpret_cast<T*>(static_cast<char*>(base) + mapped_header_size);
+            if(created)
+            {
+                stack.data_begin = stack.data_end = stack.real_begin + stack.size_real / 2;
+                stack.write_mapped_header();
+            }
+            else
+            {
+                stack.data_begin = stack.real_begin + h.begin;
+                stack.data_end   = stack.real_begin + h.end;
+                stack.direction  = h.direction;
+            }
+
+            return stack;
+        }
+
+        /**
+         * @brief sync Writes the state of a mapped stack to its file
+         * @param wait true to block until the data has reached the file
+         */
+        void sync(bool wait = false) const
+        {
+            if(map_fd < 0)
+                return;
+
+            write_mapped_header();
+            msync(map_base(), map_length(), wait ? MS_SYNC : MS_ASYNC);
+        }
+
+        /**
+         * @brief is_mapped
+         * @return true if the buffer of the stack is a file mapping
+         */
+        bool is_mapped() const { return map_fd >= 0; }
+#endif
+
         DirectionalIterator<T> begin()    const { return DirectionalIterator<T>(direction ? data_end   - 1 : data_begin    , !direction); }
         DirectionalIterator<T> rbegin()   const { return DirectionalIterator<T>(direction ? data_begin     : data_end   - 1,  direction); }
         DirectionalIterator<T> end()      const { return DirectionalIterator<T>(direction ? data_begin - 1 : data_end      , !direction); }
         DirectionalIterator<T> rend()     const { return DirectionalIterator<T>(direction ? data_end       : data_begin - 1,  direction); }
 
+        /**
+         * @brief buffer_begin Iterates the elements in memory order, bottom to top for a forward stack and top to bottom otherwise
+         * @return
+         */
+        ContiguousIterator<T> buffer_begin() const { return ContiguousIterator<T>(data_begin); }
+        ContiguousIterator<T> buffer_end()   const { return ContiguousIterator<T>(data_end); }
+
+        /**
+         * @brief strided Visits every stride-th element from the top of the stack
+         * @param stride Distance between visited elements, at least 1
+         * @param offset Index of the first visited element
+         * @return View of the elements at offset, offset + stride, offset + 2 * stride and so on
+         */
+        StridedView<T> strided(size_t stride, size_t offset = 0) const
+        {
+            if(!stride)
+                throw "Stride must not be zero";
+
+            if(offset >= size())
+                return StridedView<T>(data_begin, 1, 0);
+
+            size_t count = (size() - offset + stride - 1) / stride;
+            if(direction)
+                return StridedView<T>(data_end - 1 - offset, -ptrdiff_t(stride), count);
+            else
+                return StridedView<T>(data_begin + offset, ptrdiff_t(stride), count);
+        }
+
+        /**
+         * @brief chunks Splits the stack into contiguous blocks of n elements starting at the top
+         * The block nearest to the bottom holds the remaining elements and may be shorter.
+         * @param n
+         * @return
+         */
+        ChunkView<T> chunks(size_t n) const { return ChunkView<T>(data_begin, data_end, n, !direction); }
+
         /**
          * @brief pull_top Returns item at the top of the stack and deletes it
          * @return
@@ -292,6 +785,36 @@ namespace Types
             else return 0;
         }
 
+#ifdef __cpp_impl_coroutine
+        /**
+         * @brief drain_top Lazily yields items from the top of the stack, each item is popped when the generator moves past it
+         * Items may be moved out of while they are yielded. Stopping early leaves the remaining items in the stack.
+         * @return
+         */
+        Generator<T&> drain_top()
+        {
+            while(size())
+            {
+                co_yield *begin();
+                pop_top();
+            }
+        }
+
+        /**
+         * @brief drain_bottom Lazily yields items from the bottom of the stack, each item is popped when the generator moves past it
+         * Items may be moved out of while they are yielded. Stopping early leaves the remaining items in the stack.
+         * @return
+         */
+        Generator<T&> drain_bottom()
+        {
+            while(size())
+            {
+                co_yield *rbegin();
+                pop_bottom();
+            }
+        }
+#endif
+
         /**
          * @brief push_top Pushes val to the top of the stack
          * @param val
@@ -0,0 +1,285 @@
+#ifndef STATICSTACK_H
+#define STATICSTACK_H
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * Overflow policies of StaticStack. A push onto a full stack calls the policy's overflow() and returns its result.
+     * Throwing and failed asserts are not constant expressions, so with those policies an overflow during constant
+     * evaluation is a compile error.
+     */
+
+    /**
+     * @brief ThrowOnOverflow Throws "StaticStack overflow"
+     */
+    struct ThrowOnOverflow
+    {
+        static bool overflow() { throw "StaticStack overflow"; }
+    };
+
+    /**
+     * @brief AssertOnOverflow Asserts in debug builds, ignores the push otherwise
+     */
+    struct AssertOnOverflow
+    {
+        static bool overflow() { assert(!"StaticStack overflow"); return false; }
+    };
+
+    /**
+     * @brief ErrorOnOverflow Ignores the push, which returns false
+     */
+    struct ErrorOnOverflow
+    {
+        static constexpr bool overflow() { return false; }
+    };
+
+    /**
+     * @brief StaticStack Double ended stack of at most N elements stored inline, usable in constant expressions
+     * The elements live in a ring inside the object, so pushes at either end never move elements and the only
+     * capacity check is a compare against N. For trivially copyable T the stack is trivially copyable as well.
+     * @tparam T Default constructible element type
+     * @tparam N Capacity
+     * @tparam Overflow ThrowOnOverflow, AssertOnOverflow or ErrorOnOverflow
+     */
+    template <typename T, std::size_t N, typename Overflow = ThrowOnOverflow>
+    class StaticStack
+    {
+        static_assert(N > 0, "StaticStack needs a capacity");
+
+        T data[N] = { };
+        std::size_t first = 0;   // ring slot of the element at the front of the buffer
+        std::size_t count = 0;
+
+        /**
+         * @brief direction Direction of the stack; true for forward, false for backward
+         */
+        bool direction = true;
+
+        static constexpr std::size_t wrap(std::size_t i) { return i >= N ? i - N : i; }
+
+        constexpr std::size_t slot(std::size_t idx) const { return wrap(direction ? first + count - 1 - idx : first + idx); }
+
+        constexpr bool push_back_i(const T &val)
+        {
+            if(count == N)
+                return Overflow::overflow();
+
+            data[wrap(first + count)] = val;
+            count++;
+            return true;
+        }
+
+        constexpr bool push_front_i(const T &val)
+        {
+            if(count == N)
+                return Overflow::overflow();
+
+            first = first ? first - 1 : N - 1;
+            data[first] = val;
+            count++;
+            return true;
+        }
+
+        /**
+         * @brief discard Releases what a popped slot owns, as Stack does, so it is not kept alive until overwritten
+         * @param slot
+         */
+        static constexpr void discard(T &slot)
+        {
+            if constexpr(!std::is_trivially_destructible<T>::value)
+                slot = T();
+        }
+
+        constexpr void pop_back_i()  { discard(data[wrap(first + count - 1)]); count--; }
+        constexpr void pop_front_i() { discard(data[first]); first = wrap(first + 1); count--; }
+
+    public:
+        /**
+         * @brief Iterator Random access iterator from the top to the bottom
+         */
+        template <typename S, typename R>
+        class BasicIterator
+        {
+            S *stack = nullptr;
+            std::ptrdiff_t idx = 0;
+
+        public:
+            using iterator_concept  = std::random_access_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = T;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = R*;
+            using reference         = R&;
+
+            constexpr BasicIterator() = default;
+            constexpr BasicIterator(S *stack, std::ptrdiff_t idx) : stack(stack), idx(idx) { }
+
+            constexpr BasicIterator &operator ++() { idx++; return *this; }
+            constexpr BasicIterator &operator --() { idx--; return *this; }
+
+            constexpr BasicIterator operator ++(int) { BasicIterator copy(*this); idx++; return copy; }
+            constexpr BasicIterator operator --(int) { BasicIterator copy(*this); idx--; return copy; }
+
+            constexpr bool operator ==(const BasicIterator &other) const { return idx == other.idx; }
+            constexpr bool operator !=(const BasicIterator &other) const { return idx != other.idx; }
+            constexpr bool operator  <(const BasicIterator &other) const { return idx <  other.idx; }
+            constexpr bool operator  >(const BasicIterator &other) const { return idx >  other.idx; }
+            constexpr bool operator <=(const BasicIterator &other) const { return idx <= other.idx; }
+            constexpr bool operator >=(const BasicIterator &other) const { return idx >= other.idx; }
+
+            constexpr BasicIterator &operator +=(difference_type add) { idx += add; return *this; }
+            constexpr BasicIterator &operator -=(difference_type sub) { idx -= sub; return *this; }
+
+            constexpr BasicIterator operator +(difference_type add) const { return BasicIterator(stack, idx + add); }
+            constexpr BasicIterator operator -(difference_type sub) const { return BasicIterator(stack, idx - sub); }
+
+            friend constexpr BasicIterator operator +(difference_type add, const BasicIterator &it) { return it + add; }
+
+            constexpr difference_type operator -(const BasicIterator &sub) const { return idx - sub.idx; }
+
+            constexpr R &operator[](difference_type i) const { return stack->data[stack->slot(std::size_t(idx + i))]; }
+            constexpr R &operator *()  const { return stack->data[stack->slot(std::size_t(idx))]; }
+            constexpr R *operator ->() const { return &**this; }
+        };
+
+        using Iterator      = BasicIterator<StaticStack<T, N, Overflow>, T>;
+        using ConstIterator = BasicIterator<const StaticStack<T, N, Overflow>, const T>;
+
+        constexpr StaticStack() = default;
+
+        /**
+         * @brief StaticStack
+         * @param list Elements pushed on the top in order, so the last one ends up on top
+         * @param direction Direction of the stack; true for forward, false for backward
+         */
+        constexpr StaticStack(std::initializer_list<T> list, bool direction = true) : direction(direction)
+        {
+            for(const T &t : list)
+                push_top(t);
+        }
+
+        constexpr bool operator ==(const StaticStack<T, N, Overflow> &other) const
+        {
+            if(count != other.count)
+                return false;
+
+            for(std::size_t i = 0; i < count; i++)
+                if(data[slot(i)] != other.data[other.slot(i)])
+                    return false;
+            return true;
+        }
+
+        constexpr bool operator !=(const StaticStack<T, N, Overflow> &other) const { return !(*this == other); }
+
+        /**
+         * @brief operator [] Access element by index from the top
+         * @param idx
+         * @return
+         */
+        constexpr T &operator[](std::size_t idx)
+        {
+            if(idx >= count)
+                throw "Stack index out of bounds";
+
+            return data[slot(idx)];
+        }
+
+        constexpr const T &operator[](std::size_t idx) const
+        {
+            if(idx >= count)
+                throw "Stack index out of bounds";
+
+            return data[slot(idx)];
+        }
+
+        constexpr std::size_t size() const { return count; }
+        static constexpr std::size_t capacity() { return N; }
+
+        constexpr bool empty() const { return !count; }
+        constexpr bool full() const { return count == N; }
+
+        constexpr void clear()
+        {
+            while(count)
+                pop_back_i();
+            first = 0;
+        }
+
+        /**
+         * @brief push_top Pushes val on the top of the stack
+         * @param val
+         * @return false if the stack was full and the policy did not throw
+         */
+        constexpr bool push_top(const T &val) { return direction ? push_back_i(val) : push_front_i(val); }
+
+        /**
+         * @brief push_bottom Pushes val on the bottom of the stack
+         * @param val
+         * @return false if the stack was full and the policy did not throw
+         */
+        constexpr bool push_bottom(const T &val) { return direction ? push_front_i(val) : push_back_i(val); }
+
+        constexpr void pop_top()    { if(count) direction ? pop_back_i() : pop_front_i(); }
+        constexpr void pop_bottom() { if(count) direction ? pop_front_i() : pop_back_i(); }
+
+        /**
+         * @brief pull_top Returns item at the top of the stack and deletes it
+         * @return T() for an empty stack
+         */
+        constexpr T pull_top()
+        {
+            if(!count)
+                return T();
+
+            T t = std::move(data[slot(0)]);
+            pop_top();
+            return t;
+        }
+
+        /**
+         * @brief pull_bottom Returns item at the bottom of the stack and deletes it
+         * @return T() for an empty stack
+         */
+        constexpr T pull_bottom()
+        {
+            if(!count)
+                return T();
+
+            T t = std::move(data[slot(count - 1)]);
+            pop_bottom();
+            return t;
+        }
+
+        constexpr Iterator begin() { return Iterator(this, 0); }
+        constexpr Iterator end()   { return Iterator(this, std::ptrdiff_t(count)); }
+
+        constexpr ConstIterator begin() const { return ConstIterator(this, 0); }
+        constexpr ConstIterator end()   const { return ConstIterator(this, std::ptrdiff_t(count)); }
+
+        /**
+         * @brief getDirection Get the direction of the stack
+         * @return true for forward, false for backward
+         */
+        constexpr bool getDirection() const { return direction; }
+
+        /**
+         * @brief setDirection Set the direction of the stack
+         * @param dir forward, false for backward
+         */
+        constexpr void setDirection(bool dir) { direction = dir; }
+
+        /**
+         * @brief reverse Reverses the direction of the stack
+         */
+        constexpr void reverse() { direction = !direction; }
+    };
+}
+
+#endif // STATICSTACK_H
@@ -0,0 +1,139 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Counters and observer calls are only compiled in when TYPES_ENABLE_STATS is defined for the whole program.
+ * Without it stats() only reports what can be computed from the current state and no hooks are called.
+ */
+
+namespace Types
+{
+    /**
+     * @brief StackStats Usage statistics of a Stack
+     */
+    struct StackStats
+    {
+        std::size_t resizes = 0;         // number of buffer reallocations
+        std::size_t bytes_relocated = 0; // bytes of elements moved by reallocations
+        std::size_t peak_size = 0;       // largest number of elements held at once
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+
+        /**
+         * @brief gap_waste
+         * @return Number of allocated element slots not holding an element
+         */
+        std::size_t gap_waste() const { return capacity - size; }
+    };
+
+    /**
+     * @brief TreeStats Shape statistics of a Tree and its descendants
+     */
+    struct TreeStats
+    {
+        std::size_t nodes = 0;
+        std::size_t depth = 0;           // edges on the longest path down from the node
+        std::vector<std::size_t> fanout; // fanout[k] is the number of nodes with k children
+        std::size_t map_entries = 0;     // entries in the children maps
+        std::size_t map_bytes = 0;       // estimated heap bytes of the children map nodes
+    };
+
+    /**
+     * @brief TreeMemory Bytes used by a Tree and its descendants per category
+     */
+    struct TreeMemory
+    {
+        std::size_t nodes = 0;          // Tree objects, including labels and contents stored inline
+        std::size_t children_maps = 0;  // nodes of the children maps
+        std::size_t child_arrays = 0;   // buffers of enabled child indexes
+        std::size_t extras = 0;         // side blocks of nodes with child indexing or in a tree with a tree state
+        std::size_t label_index = 0;    // tree state and label index, counted with the root that owns them
+        std::size_t labels = 0;         // heap buffers of labels and of their copies in the children maps
+        std::size_t contents = 0;       // heap memory owned by contents, as reported by heapUsage()
+
+        std::size_t total() const { return nodes + children_maps + child_arrays + extras + label_index + labels + contents; }
+    };
+
+    /**
+     * @brief heapUsage Heap bytes owned by an object besides its own size, overload it for types that own memory
+     * @return 0 for types without an overload
+     */
+    template <typename X>
+    std::size_t heapUsage(const X &) { return 0; }
+
+    template <typename C, typename Tr, typename A>
+    std::size_t heapUsage(const std::basic_string<C, Tr, A> &s)
+    {
+        const char *data = reinterpret_cast<const char*>(s.data());
+        const char *self = reinterpret_cast<const char*>(&s);
+        bool inline_buffer = data >= self && data < self + sizeof(s);
+        return inline_buffer ? 0 : (s.capacity() + 1) * sizeof(C);
+    }
+
+    template <typename X, typename A>
+    std::size_t heapUsage(const std::vector<X, A> &v) { return v.capacity() * sizeof(X); }
+
+    /**
+     * @brief mapNodeBytes Size of a std::map node holding Value, a color and three links besides the value in libstdc++
+     * @return
+     */
+    template <typename Value>
+    constexpr std::size_t mapNodeBytes() { return 4 * sizeof(void*) + sizeof(Value); }
+
+    /**
+     * @brief allocatedBytes Size of the chunk the glibc allocator uses for a request of bytes
+     * @param bytes
+     * @return
+     */
+    constexpr std::size_t allocatedBytes(std::size_t bytes)
+    {
+        std::size_t chunk = (bytes + sizeof(std::size_t) + 15) & ~std::size_t(15);
+        return chunk < 32 ? 32 : chunk;
+    }
+
+    /**
+     * @brief StatsObserver Receives events from all stacks and trees while installed with setStatsObserver()
+     */
+    class StatsObserver
+    {
+    public:
+        virtual ~StatsObserver() = default;
+
+        virtual void stackResized(const void *stack, std::size_t old_capacity, std::size_t new_capacity, std::size_t bytes_relocated)
+        { (void)stack; (void)old_capacity; (void)new_capacity; (void)bytes_relocated; }
+
+        virtual void treeNodeAdded(const void *node, const void *parent) { (void)node; (void)parent; }
+        virtual void treeNodeRemoved(const void *node) { (void)node; }
+    };
+
+    inline StatsObserver *stats_observer = nullptr;
+
+    /**
+     * @brief setStatsObserver Installs the observer notified when TYPES_ENABLE_STATS is defined
+     * @param observer nullptr to remove the current observer
+     */
+    inline void setStatsObserver(StatsObserver *observer) { stats_observer = observer; }
+
+    inline StatsObserver *getStatsObserver() { return stats_observer; }
+
+    /**
+     * @brief ScopedStatsObserver Installs an observer for its lifetime and restores the previous one afterwards
+     */
+    class ScopedStatsObserver
+    {
+        StatsObserver *previous;
+
+    public:
+        ScopedStatsObserver(StatsObserver *observer) : previous(stats_observer) { stats_observer = observer; }
+        ~ScopedStatsObserver() { stats_observer = previous; }
+
+        ScopedStatsObserver(const ScopedStatsObserver &) = delete;
+        ScopedStatsObserver &operator=(const ScopedStatsObserver &) = delete;
+    };
+}
+
+#endif // STATS_H
@@ -1,41 +1,217 @@
 #ifndef TREE_H
 #define TREE_H
 
+#include "aggregates.h"
 #include "directionaliterator.h"
+#include "labelpattern.h"
+#include "stats.h"
 
+#ifdef __cpp_impl_coroutine
+#include "generator.h"
+#endif
+
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace Types
 {
-    template <typename T, typename U = std::string>
-    class Tree
+    /**
+     * @brief Tree
+     * @tparam T Contents of a node
+     * @tparam U Label of a node, void or ForwardOnly for the unlabeled trees of compacttree.h
+     * @tparam A Subtree aggregate cached in every node, see aggregates.h and aggregate()
+     */
+    template <typename T, typename U = std::string, typename A = NoAggregate>
+    class Tree : private AggregateCache<A>
     {
-        Tree<T, U> *parent = nullptr;
+        Tree<T, U, A> *parent = nullptr;
 
         U label;
         bool labeled = false;
 
-        Tree<T, U> *left_node  = nullptr;
-        Tree<T, U> *right_node = nullptr;
+        Tree<T, U, A> *left_node  = nullptr;
+        Tree<T, U, A> *right_node = nullptr;
+
+        std::map<U, Tree<T, U, A>*> children;
+
+        Tree<T, U, A> *first_child  = nullptr;
+        Tree<T, U, A> *last_child   = nullptr;
+
+        /**
+         * @brief LabelIndex Labeled nodes of a whole tree by label, owned by the root that enabled it
+         * Every node stores its position in the vector of its label, so it is removed in O(log labels).
+         */
+        struct LabelIndex
+        {
+            Tree<T, U, A> *root;
+            std::map<U, std::vector<Tree<T, U, A>*>> nodes;
+
+            void add(Tree<T, U, A> *node)
+            {
+                std::vector<Tree<T, U, A>*> &v = nodes[node->label];
+                node->extras->label_slot = v.size();
+                v.push_back(node);
+            }
+
+            void remove(Tree<T, U, A> *node)
+            {
+                auto it = nodes.find(node->label);
+                std::vector<Tree<T, U, A>*> &v = it->second;
 
-        std::map<U, Tree<T, U>*> children;
+                std::size_t slot = node->extras->label_slot;
+                v[slot] = v.back();
+                v[slot]->extras->label_slot = slot;
+                v.pop_back();
 
-        Tree<T, U> *first_child  = nullptr;
-        Tree<T, U> *last_child   = nullptr;
+                if(v.empty())
+                    nodes.erase(it);
+            }
+        };
+
+        /**
+         * @brief Watch Version of the structure of a whole tree, shared by the StructureWatch handles on it
+         * Linked from every node while a handle exists and outlives the tree, root is reset once the root is
+         * destroyed or linked below another node.
+         */
+        struct Watch : std::enable_shared_from_this<Watch>
+        {
+            Tree<T, U, A> *root;
+
+            /**
+             * @brief version Bumped whenever a node of this tree is linked, reordered or destroyed
+             */
+            std::size_t version = 0;
+
+            explicit Watch(Tree<T, U, A> *root) : root(root) { }
+        };
+
+        /**
+         * @brief Extras State of a node that only exists while child indexing, a label index or a watch is used
+         * Kept out of line, so a node with neither costs one pointer. The children of a node with child indexing keep
+         * theirs for their position in its child array.
+         */
+        struct Extras
+        {
+            /**
+             * @brief child_array Children in sibling order, only kept while child_array_enabled
+             * A destroyed child leaves a nullptr hole at its child_slot, the holes are dropped by the next indexed access.
+             */
+            std::vector<Tree<T, U, A>*> child_array;
+            std::size_t child_holes = 0;
+            bool child_array_enabled = false;
+
+            LabelIndex *label_index = nullptr;
+            std::size_t label_slot = 0;
+
+            Watch *watch = nullptr;
+            std::size_t child_slot = 0;
+        };
+
+        Extras *extras = nullptr;
 
         T contents;
 
-        Tree(const T &t, Tree<T, U> *parent) { this->contents = t; this->parent = parent;  }
-        Tree(T &&t, Tree<T, U> *parent)      { this->contents = std::move(t); this->parent = parent; }
+        struct labeled_t { };
+
+        template <typename... Args>
+        Tree(std::in_place_t, Tree<T, U, A> *parent, Args&&... args)
+            : parent(parent), contents(std::forward<Args>(args)...) { }
 
-        Tree(const T &t, Tree<T, U> *parent, U label) : Tree(t, parent)            { this->label = label; labeled = true;  }
-        Tree(T &&t, Tree<T, U> *parent, U label)      : Tree(std::move(t), parent) { this->label = label; labeled = true; }
+        template <typename... Args>
+        Tree(labeled_t, Tree<T, U, A> *parent, const U &label, Args&&... args)
+            : parent(parent), label(label), labeled(true), contents(std::forward<Args>(args)...) { }
 
-        void appendChild(Tree<T, U> *child)
+        Tree(const T &t, Tree<T, U, A> *parent) : Tree(std::in_place, parent, t) { }
+        Tree(T &&t, Tree<T, U, A> *parent)      : Tree(std::in_place, parent, std::move(t)) { }
+
+        LabelIndex *labelIndex() const { return extras ? extras->label_index : nullptr; }
+        Watch *treeWatch() const        { return extras ? extras->watch : nullptr; }
+
+        /**
+         * @brief joinTree Links this node to the label index and watch of its tree
+         * @param index
+         * @param watch
+         */
+        void joinTree(LabelIndex *index, Watch *watch)
+        {
+            LabelIndex *old_index = labelIndex();
+            if(old_index && old_index != index && labeled)
+                old_index->remove(this);
+
+            if((index || watch) && !extras)
+                extras = new Extras();
+            if(extras)
+            {
+                extras->label_index = index;
+                extras->watch = watch;
+            }
+
+            if(index && index != old_index && labeled)
+                index->add(this);
+            trimExtras();
+        }
+
+        /**
+         * @brief trimExtras Frees the extras of this node once nothing uses them
+         */
+        void trimExtras()
+        {
+            if(extras && !extras->label_index && !extras->watch && !extras->child_array_enabled && !(parent && parent->getChildIndexing()))
+            {
+                delete extras;
+                extras = nullptr;
+            }
+        }
+
+        /**
+         * @brief indexChild Stores child at the end of the child array, requires child indexing
+         * @param child
+         */
+        void indexChild(Tree<T, U, A> *child)
+        {
+            if(!child->extras)
+                child->extras = new Extras();
+
+            child->extras->child_slot = extras->child_array.size();
+            extras->child_array.push_back(child);
+        }
+
+        /**
+         * @brief compactChildren Drops the holes destroyed children left in the child array, requires child indexing
+         */
+        void compactChildren() const
+        {
+            if(!extras->child_holes)
+                return;
+
+            std::vector<Tree<T, U, A>*> &child_array = extras->child_array;
+            child_array.erase(std::remove(child_array.begin(), child_array.end(), nullptr), child_array.end());
+            for(std::size_t i = 0; i < child_array.size(); i++)
+                child_array[i]->extras->child_slot = i;
+            extras->child_holes = 0;
+        }
+
+        const std::vector<Tree<T, U, A>*> &childArray() const
+        {
+            static const std::vector<Tree<T, U, A>*> none;
+            if(!getChildIndexing())
+                return none;
+
+            compactChildren();
+            return extras->child_array;
+        }
+
+        void appendChild(Tree<T, U, A> *child)
         {
             if(first_child)
             {
@@ -48,6 +224,258 @@ namespace Types
             }
 
             last_child = child;
+            if(getChildIndexing())
+                indexChild(child);
+            else
+                child->trimExtras();
+
+            if(child->labelIndex() != labelIndex() || child->treeWatch() != treeWatch())
+                adoptTree(child);
+
+            invalidate();
+            structureChanged();
+
+#ifdef TYPES_ENABLE_STATS
+            if(stats_observer)
+                stats_observer->treeNodeAdded(child, this);
+#endif
+        }
+
+        /**
+         * @brief unlinkChildren Moves the children of this node to pending and leaves them without parent or siblings
+         * @param pending
+         */
+        void unlinkChildren(std::vector<Tree<T, U, A>*> &pending)
+        {
+            for(Tree<T, U, A> *c = first_child; c; )
+            {
+                Tree<T, U, A> *next = c->right_node;
+                c->parent = c->left_node = c->right_node = nullptr;
+                pending.push_back(c);
+                c = next;
+            }
+
+            first_child = last_child = nullptr;
+            children.clear();
+            if(extras)
+            {
+                extras->child_array.clear();
+                extras->child_holes = 0;
+            }
+        }
+
+        /**
+         * @brief invalidate Marks the cached aggregate of this node and of its ancestors as stale
+         */
+        void invalidate()
+        {
+            if constexpr(!std::is_same<A, NoAggregate>::value)
+                for(Tree<T, U, A> *node = this; node && !node->aggregate_dirty; node = node->parent)
+                    node->aggregate_dirty = true;
+        }
+
+        /**
+         * @brief structureChanged Bumps the version of the tree of this node, if it is watched
+         */
+        void structureChanged()
+        {
+            if(Watch *watch = treeWatch())
+                watch->version++;
+        }
+
+        /**
+         * @brief adoptTree Moves the subtree of node to the label index and watch of this tree
+         * A label index or watch node was the root of is left behind: the index is deleted and the watch goes stale.
+         * @param node
+         */
+        void adoptTree(Tree<T, U, A> *node)
+        {
+            LabelIndex *old_index = node->labelIndex();
+            Watch *old_watch = node->treeWatch();
+
+            node->walkSubtree([&](const Tree<T, U, A> *n, std::size_t) {
+                const_cast<Tree<T, U, A>*>(n)->joinTree(labelIndex(), treeWatch());
+            });
+
+            if(old_index && old_index->root == node)
+                delete old_index;
+            if(old_watch && old_watch->root == node)
+            {
+                old_watch->root = nullptr;
+                old_watch->version++;
+            }
+        }
+
+        /**
+         * @brief unwatch Unlinks the watch of the tree rooted at this node once the last StructureWatch on it is gone
+         */
+        void unwatch()
+        {
+            walkSubtree([&](const Tree<T, U, A> *n, std::size_t) {
+                const_cast<Tree<T, U, A>*>(n)->joinTree(n->labelIndex(), nullptr);
+            });
+        }
+
+        /**
+         * @brief queryDown Appends the nodes below node that match the segments of pattern from segment idx on
+         * Walks the labeled children with an explicit stack, "**" segments branch into every labeled child.
+         */
+        void queryDown(const LabelPattern &pattern, Tree<T, U, A> *node, std::size_t idx, std::vector<Tree<T, U, A>*> &result) const
+        {
+            std::vector<std::pair<Tree<T, U, A>*, std::size_t>> pending = { { node, idx } };
+
+            while(pending.size())
+            {
+                auto [n, i] = pending.back();
+                pending.pop_back();
+
+                if(i == pattern.size())
+                {
+                    result.push_back(n);
+                    continue;
+                }
+
+                const LabelPattern::Segment &seg = pattern[i];
+                if(seg.kind == LabelPattern::LITERAL)
+                {
+                    auto it = n->children.find(U(seg.text));
+                    if(it != n->children.end() && it->second)
+                        pending.emplace_back(it->second, i + 1);
+                    continue;
+                }
+
+                for(auto it = n->children.rbegin(); it != n->children.rend(); it++)
+                {
+                    if(!it->second)
+                        continue;
+
+                    if(seg.kind == LabelPattern::RECURSIVE)
+                        pending.emplace_back(it->second, i);
+                    else if(pattern.matches(i, it->first))
+                        pending.emplace_back(it->second, i + 1);
+                }
+
+                if(seg.kind == LabelPattern::RECURSIVE)
+                    pending.emplace_back(n, i + 1);
+            }
+        }
+
+        /**
+         * @brief queryIndexed Looks up the nodes labeled like segment idx of pattern and checks the rest of the pattern around them
+         */
+        void queryIndexed(const LabelPattern &pattern, std::size_t idx, std::vector<Tree<T, U, A>*> &result) const
+        {
+            auto it = labelIndex()->nodes.find(U(pattern[idx].text));
+            if(it == labelIndex()->nodes.end())
+                return;
+
+            std::vector<std::string_view> path;
+            for(Tree<T, U, A> *candidate : it->second)
+            {
+                // labels between this node and the candidate, which must lie below it and be reachable by labels
+                path.clear();
+                const Tree<T, U, A> *n = candidate->parent;
+                while(n && n != this && n->labeled)
+                {
+                    path.push_back(n->label);
+                    n = n->parent;
+                }
+
+                if(n != this)
+                    continue;
+
+                std::reverse(path.begin(), path.end());
+                if(pattern.matchPath(0, idx, path))
+                    queryDown(pattern, candidate, idx + 1, result);
+            }
+        }
+
+        /**
+         * @brief firstDirty First node in the sibling list starting at node whose aggregate is stale
+         */
+        static const Tree<T, U, A> *firstDirty(const Tree<T, U, A> *node)
+        {
+            while(node && !node->aggregate_dirty)
+                node = node->right_node;
+            return node;
+        }
+
+        /**
+         * @brief nextPreorder Node following node in a preorder walk of this subtree
+         * @param node
+         * @return The next node or nullptr if node was the last one
+         */
+        Tree<T, U, A> *nextPreorder(Tree<T, U, A> *node) const
+        {
+            if(node->first_child)
+                return node->first_child;
+
+            while(node != this && !node->right_node)
+                node = node->parent;
+
+            return node == this ? nullptr : node->right_node;
+        }
+
+        /**
+         * @brief walkSubtree Calls f(node, depth) for this node and all of its descendants in preorder, without recursion
+         * @param f
+         */
+        template <typename F>
+        void walkSubtree(F f) const
+        {
+            const Tree<T, U, A> *node = this;
+            std::size_t depth = 0;
+
+            while(node)
+            {
+                f(node, depth);
+
+                if(node->first_child)
+                {
+                    node = node->first_child;
+                    depth++;
+                    continue;
+                }
+
+                while(node != this && !node->right_node)
+                {
+                    node = node->parent;
+                    depth--;
+                }
+
+                node = node == this ? nullptr : node->right_node;
+            }
+        }
+
+        /**
+         * @brief setChildImpl Replaces the contents of the child labeled label or creates it
+         * @param label
+         * @param args Arguments to construct the contents from
+         * @return The child
+         */
+        template <typename... Args>
+        Tree<T, U, A> *setChildImpl(const U &label, Args&&... args)
+        {
+            auto it = children.lower_bound(label);
+            bool found = it != children.end() && !children.key_comp()(label, it->first);
+
+            if(found && it->second)
+            {
+                Tree<T, U, A> *child = it->second;
+                child->clear();
+                child->contents = T(std::forward<Args>(args)...);
+                child->invalidate();
+                return child;
+            }
+
+            Tree<T, U, A> *child = new Tree<T, U, A>(labeled_t(), this, label, std::forward<Args>(args)...);
+            appendChild(child);
+            if(found)
+                it->second = child;
+            else
+                children.emplace_hint(it, label, child);
+
+            return child;
         }
 
      public:
@@ -68,23 +496,56 @@ namespace Types
          * @brief Tree Copy constructor
          * @param other
          */
-        Tree(const Tree<T, U> &other) { contents = other.contents; *this = other; }
+        Tree(const Tree<T, U, A> &other) { contents = other.contents; *this = other; }
 
         /**
          * @brief Tree Move constructor
          * @param other
          */
-        Tree(Tree<T, U> &&other) { contents = other.contents; *this = std::move(other); }
+        Tree(Tree<T, U, A> &&other) { contents = other.contents; *this = std::move(other); }
 
         ~Tree()
         {
-            if(labeled && parent)
-                parent->children[label] = nullptr;
+            if(labelIndex() && labeled)
+                labelIndex()->remove(this);
+
+            if(parent)
+            {
+                if(labeled)
+                {
+                    auto it = parent->children.find(label);
+                    if(it != parent->children.end() && it->second == this)
+                        parent->children.erase(it);
+                }
+
+                if(parent->first_child == this) parent->first_child = right_node;
+                if(parent->last_child  == this) parent->last_child  = left_node;
+
+                if(parent->getChildIndexing())
+                {
+                    parent->extras->child_array[extras->child_slot] = nullptr;
+                    parent->extras->child_holes++;
+                }
+
+                parent->invalidate();
+            }
 
             if(left_node)  left_node->right_node = right_node;
             if(right_node) right_node->left_node = left_node;
 
+            structureChanged();
             clear();
+
+            if(labelIndex() && labelIndex()->root == this)
+                delete labelIndex();
+            if(treeWatch() && treeWatch()->root == this)
+                treeWatch()->root = nullptr;
+            delete extras;
+
+#ifdef TYPES_ENABLE_STATS
+            if(stats_observer)
+                stats_observer->treeNodeRemoved(this);
+#endif
         }
 
         /**
@@ -92,18 +553,29 @@ namespace Types
          * @param other
          * @return
          */
-        Tree<T, U> &operator=(const Tree<T, U> &other)
+        Tree<T, U, A> &operator=(const Tree<T, U, A> &other)
         {
+            if(this == &other)
+                return *this;
+
             contents = other.contents;
+
+            if(labelIndex() && labeled)
+                labelIndex()->remove(this);
             label = other.label;
+            if(labelIndex() && labeled)
+                labelIndex()->add(this);
 
+            invalidate();
+
+            clear();
             children.clear();
-            for(Tree<T, U> &a : *this)
-                delete &a;
 
-            for(Tree<T, U> &c : other)
+            for(Tree<T, U, A> &c : other)
             {
-                Tree<T, U> *cc = new Tree<T, U>(c);
+                Tree<T, U, A> *cc = new Tree<T, U, A>(c);
+                cc->parent = this;
+                cc->labeled = c.labeled;
                 appendChild(cc);
                 if(c.labeled)
                     children[c.label] = cc;
@@ -117,26 +589,35 @@ namespace Types
          * @param other
          * @return
          */
-        Tree<T, U> &operator=(Tree<T, U> &&other)
+        Tree<T, U, A> &operator=(Tree<T, U, A> &&other)
         {
+            if(this == &other)
+                return *this;
+
             contents = std::move(other.contents);
+            invalidate();
 
+            clear();
             children.clear();
-            for(auto a : *this)
-                delete &*a;
 
-            first_child = nullptr;
-            last_child  = nullptr;
-
-            for(Tree<T, U> &c : other)
+            for(Tree<T, U, A> &c : other)
             {
+                c.parent = this;
                 appendChild(&c);
                 if(c.labeled)
                     children[c.label] = &c;
             }
 
+            other.children.clear();
+            if(other.extras)
+            {
+                other.extras->child_array.clear();
+                other.extras->child_holes = 0;
+            }
             other.first_child = nullptr;
             other.last_child  = nullptr;
+            other.invalidate();
+            other.structureChanged();
 
             return *this;
         }
@@ -146,13 +627,13 @@ namespace Types
          * @param other
          * @return true if both trees contain the same elements in the same order (compared with !=)
          */
-        bool operator ==(const Tree<T, U> &other) const
+        bool operator ==(const Tree<T, U, A> &other) const
         {
             if(contents != other.contents)
                 return false;
 
             auto it = other.begin();
-            for(Tree<T, U> &c : *this)
+            for(Tree<T, U, A> &c : *this)
             {
                 if(it.getPtr() == nullptr)
                     return false;
@@ -174,13 +655,13 @@ namespace Types
          * @param other
          * @return true if both trees contain the same elements in the same order (compared with ==)
          */
-        bool operator !=(const Tree<T, U> &other) const
+        bool operator !=(const Tree<T, U, A> &other) const
         {
             if(contents != other.contents)
                 return true;
 
             auto it = other.begin();
-            for(Tree<T, U> &c : *this)
+            for(Tree<T, U, A> &c : *this)
             {
                 if(it.getPtr() == nullptr)
                     return true;
@@ -199,62 +680,187 @@ namespace Types
 
         /**
          * @brief operator [] Access child
-         * @param idx Index of child
-         * @return
+         * @param label Label of child
+         * @return The child or nullptr, a miss does not modify the tree
          */
-        Tree<T, U>* operator[](U label) { return children[label]; }
+        Tree<T, U, A>* operator[](const U &label) const
+        {
+            auto it = children.find(label);
+            return it == children.end() ? nullptr : it->second;
+        }
 
         /**
          * @brief getContents Access contained data
+         * Changes made through the reference are not seen by aggregate(), use setContents() or modifyContents() for those.
          * @return Reference to contained data
          */
         T &getContents() { return contents; }
+        const T &getContents() const { return contents; }
 
-        Tree<T, U> *getParent() { return parent; }
+        /**
+         * @brief setContents Replaces the contained data and marks the cached aggregates above this node as stale
+         * @param t
+         */
+        void setContents(const T &t) { contents = t; invalidate(); }
+        void setContents(T &&t)      { contents = std::move(t); invalidate(); }
+
+        /**
+         * @brief modifyContents Calls f with a reference to the contained data and marks the cached aggregates above this node as stale
+         * @param f
+         */
+        template <typename F>
+        void modifyContents(F f) { f(contents); invalidate(); }
+
+        Tree<T, U, A> *getParent() { return parent; }
+
+        /**
+         * @brief StructureWatch Handle on the structure version of a tree, see watchStructure()
+         * Stays safe to use after the tree is gone; it is alive while its root exists and is still a root.
+         */
+        class StructureWatch
+        {
+            friend class Tree<T, U, A>;
+
+            std::shared_ptr<Watch> watch;
+
+            void release()
+            {
+                if(watch && watch.use_count() == 1 && watch->root)
+                    watch->root->unwatch();
+            }
+
+        public:
+            StructureWatch() = default;
+            StructureWatch(const StructureWatch &) = default;
+            StructureWatch(StructureWatch &&) = default;
+
+            StructureWatch &operator=(StructureWatch other) { std::swap(watch, other.watch); return *this; }
+
+            ~StructureWatch() { release(); }
+
+            /**
+             * @brief alive
+             * @return false once the watched root was destroyed or linked below another node
+             */
+            bool alive() const { return watch && watch->root; }
+
+            /**
+             * @brief version Changes whenever a node of the watched tree is added, reordered or destroyed
+             * Only the nodes of that tree bump it, so changes to other trees leave it alone.
+             * @return
+             */
+            std::size_t version() const { return watch ? watch->version : 0; }
+
+            /**
+             * @brief root
+             * @return The watched root or nullptr if the watch is not alive
+             */
+            Tree<T, U, A> *root() const { return watch ? watch->root : nullptr; }
+        };
+
+        /**
+         * @brief watchStructure Makes the tree rooted at this node keep a version of its structure while the returned handle exists
+         * @return
+         */
+        StructureWatch watchStructure()
+        {
+            if(parent)
+                throw "Tree structure can only be watched from the root";
+
+            StructureWatch handle;
+            if(treeWatch())
+            {
+                handle.watch = treeWatch()->shared_from_this();
+                return handle;
+            }
+
+            handle.watch = std::make_shared<Watch>(this);
+            walkSubtree([&](const Tree<T, U, A> *n, std::size_t) {
+                const_cast<Tree<T, U, A>*>(n)->joinTree(n->labelIndex(), handle.watch.get());
+            });
+            return handle;
+        }
 
         /**
          * @brief operator * same as getContents()
          * @return
          */
         T &operator*() { return getContents(); }
+        const T &operator*() const { return getContents(); }
+
 
+        void addChild(T &t)           { appendChild(new Tree<T, U, A>(t,            this)); }
+        void addChild(T &&t)          { appendChild(new Tree<T, U, A>(std::move(t), this)); }
 
-        void addChild(T &t)           { appendChild(new Tree<T, U>(t,            this)); }
-        void addChild(T &&t)          { appendChild(new Tree<T, U>(std::move(t), this)); }
+        /**
+         * @brief setChild Sets the child labeled label to contain t. An existing child with the same
+         * label keeps its place among the siblings, gets its contents replaced and its children cleared.
+         * @param t
+         * @param label
+         */
+        void setChild(T &t,  U label) { setChildImpl(label, t); }
+        void setChild(T &&t, U label) { setChildImpl(label, std::move(t)); }
 
-        void setChild(T &t,  U label)
+        /**
+         * @brief emplaceChild Appends an unlabeled child with contents constructed in place from args
+         * @param args
+         * @return The new child
+         */
+        template <typename... Args>
+        Tree<T, U, A> *emplaceChild(Args&&... args)
         {
-            Tree<T, U> *child = new Tree<T, U>(t, this, label);
-            if(children[label] == nullptr) appendChild(child);
-            children[label] = child;
+            Tree<T, U, A> *child = new Tree<T, U, A>(std::in_place, this, std::forward<Args>(args)...);
+            appendChild(child);
+            return child;
         }
 
-        void setChild(T &&t,  U label)
+        /**
+         * @brief emplaceLabeledChild Same as setChild() but constructs the contents of a new child in place from args
+         * @param label
+         * @param args
+         * @return The child labeled label
+         */
+        template <typename... Args>
+        Tree<T, U, A> *emplaceLabeledChild(const U &label, Args&&... args) { return setChildImpl(label, std::forward<Args>(args)...); }
+
+        /**
+         * @brief addChildren Appends an unlabeled child for every element of range
+         * @param range Anything iterable with elements T can be constructed from
+         */
+        template <typename Range>
+        void addChildren(const Range &range)
         {
-            Tree<T, U> *child = new Tree<T, U>(std::move(t), this, label);
-            if(children[label] == nullptr) appendChild(child);
-            children[label] = child;
+            for(const auto &t : range)
+                appendChild(new Tree<T, U, A>(std::in_place, this, t));
         }
 
-        U getLabel()
+        void addChildren(std::initializer_list<T> list) { addChildren<std::initializer_list<T>>(list); }
+
+        const U &getLabel() const
         {
             return label;
         }
 
+        /**
+         * @brief isLabeled
+         * @return true if the node was created with setChild() and has a label
+         */
+        bool isLabeled() const { return labeled; }
+
         class TreeIterator : public std::iterator<std::bidirectional_iterator_tag, T>
         {
         public:
             enum WENT_OVER { OVER_LEFT, OVER_NOT, OVER_RIGHT };
         private:
 
-            Tree<T, U>* ptr;
-            Tree<T, U>* prePtr;
+            Tree<T, U, A>* ptr;
+            Tree<T, U, A>* prePtr;
 
             WENT_OVER over;
 
         public:
 
-            TreeIterator(Tree<T, U>* ptr, Tree<T, U>* pp = nullptr, WENT_OVER o = OVER_NOT) { this->ptr = ptr;       this->prePtr = pp;           this->over = o;          }
+            TreeIterator(Tree<T, U, A>* ptr, Tree<T, U, A>* pp = nullptr, WENT_OVER o = OVER_NOT) { this->ptr = ptr;       this->prePtr = pp;           this->over = o;          }
             TreeIterator(const TreeIterator &other)                                         { this->ptr = other.ptr; this->prePtr = other.prePtr; this->over = other.over; }
 
             const TreeIterator &operator ++()
@@ -278,10 +884,10 @@ namespace Types
             bool operator ==(const TreeIterator &other) const { return ptr == other.ptr; }
             bool operator !=(const TreeIterator &other) const { return ptr != other.ptr; }
 
-            Tree<T, U>  &operator *()  const { return *ptr; }
-            Tree<T, U>  *operator ->() const { return ptr; }
+            Tree<T, U, A>  &operator *()  const { return *ptr; }
+            Tree<T, U, A>  *operator ->() const { return ptr; }
 
-            Tree<T, U> *getPtr() { return ptr; };
+            Tree<T, U, A> *getPtr() { return ptr; };
         };
 
         TreeIterator begin()  const { return TreeIterator(first_child); }
@@ -290,21 +896,429 @@ namespace Types
         TreeIterator rbegin() const { return TreeIterator(last_child); }
         TreeIterator rend()   const { return TreeIterator(nullptr, first_child, TreeIterator::OVER_LEFT); }
 
+#ifdef __cpp_impl_coroutine
         /**
-         * @brief clear Deletes all children
+         * @brief walkPreorder Lazily yields this node and all of its descendants in preorder
+         * Follows the sibling and parent links, so it needs no memory besides the coroutine frame.
+         * The tree must not be modified while walking.
+         * @return
+         */
+        Generator<Tree<T, U, A>&> walkPreorder()
+        {
+            Tree<T, U, A> *node = this;
+            while(node)
+            {
+                co_yield *node;
+                node = nextPreorder(node);
+            }
+        }
+
+        /**
+         * @brief walkLeaves Lazily yields the nodes without children in this subtree, left to right
+         * The tree must not be modified while walking.
+         * @return
+         */
+        Generator<Tree<T, U, A>&> walkLeaves()
+        {
+            Tree<T, U, A> *node = this;
+            while(node)
+            {
+                if(!node->first_child)
+                    co_yield *node;
+                node = nextPreorder(node);
+            }
+        }
+#endif
+
+        /**
+         * @brief aggregate Value of A over this subtree, recomputed for the stale nodes only
+         * Stale nodes are those below which a node was added or destroyed or whose contents were set or modified.
+         * The recomputation walks the stale nodes in postorder without recursion and skips clean subtrees, so repeated
+         * queries are O(1). Not thread safe, even though it is const.
+         * @return A::node(contents, combined aggregates of the children)
+         */
+        template <typename B = A>
+        const typename B::value_type &aggregate() const
+        {
+
+            const Tree<T, U, A> *node = this->aggregate_dirty ? this : nullptr;
+            while(node)
+            {
+                if(const Tree<T, U, A> *c = firstDirty(node->first_child))
+                {
+                    node = c;
+                    continue;
+                }
+
+                // the children of node are clean, finish it and go on with its next stale sibling or its parent
+                while(true)
+                {
+                    typename A::value_type children = A::identity();
+                    for(const Tree<T, U, A> *c = node->first_child; c; c = c->right_node)
+                        children = A::combine(children, c->aggregate_value);
+
+                    node->aggregate_value = A::node(node->contents, children);
+                    node->aggregate_dirty = false;
+
+                    if(node == this)
+                        return this->aggregate_value;
+
+                    if(const Tree<T, U, A> *s = firstDirty(node->right_node))
+                    {
+                        node = s;
+                        break;
+                    }
+                    node = node->parent;
+                }
+            }
+
+            return this->aggregate_value;
+        }
+
+        /**
+         * @brief stats Walks this node and its descendants without recursion
+         * @return Node count, depth, fan-out histogram and an estimate of the children map footprint
+         */
+        TreeStats stats() const
+        {
+            TreeStats s;
+
+            walkSubtree([&](const Tree<T, U, A> *node, std::size_t depth) {
+                std::size_t k = node->childCount();
+                if(k >= s.fanout.size())
+                    s.fanout.resize(k + 1);
+                s.fanout[k]++;
+
+                s.nodes++;
+                s.map_entries += node->children.size();
+                if(depth > s.depth)
+                    s.depth = depth;
+            });
+
+            s.map_bytes = s.map_entries * mapNodeBytes<typename std::map<U, Tree<T, U, A>*>::value_type>();
+
+            return s;
+        }
+
+        /**
+         * @brief memoryBreakdown Walks this node and its descendants without recursion or allocation
+         * @param allocator_overhead true to round every heap block up to the chunk size of the system allocator
+         * @return Bytes used by the subtree per category
+         */
+        TreeMemory memoryBreakdown(bool allocator_overhead = false) const
+        {
+            TreeMemory m;
+            auto block = [&](std::size_t bytes) { return allocator_overhead ? allocatedBytes(bytes) : bytes; };
+            auto heap = [&](std::size_t bytes) { return bytes ? block(bytes) : 0; };
+
+            const std::size_t map_node = mapNodeBytes<typename std::map<U, Tree<T, U, A>*>::value_type>();
+            const std::size_t index_node = mapNodeBytes<typename std::map<U, std::vector<Tree<T, U, A>*>>::value_type>();
+
+            walkSubtree([&](const Tree<T, U, A> *node, std::size_t) {
+                m.nodes          += node == this ? sizeof(Tree<T, U, A>) : block(sizeof(Tree<T, U, A>));
+                m.children_maps  += node->children.size() * block(map_node);
+                if(node->extras)
+                {
+                    m.extras       += block(sizeof(Extras));
+                    m.child_arrays += heap(node->extras->child_array.capacity() * sizeof(Tree<T, U, A>*));
+                }
+
+                const LabelIndex *index = node->labelIndex();
+                if(index && index->root == node)
+                {
+                    m.label_index += block(sizeof(LabelIndex));
+                    for(const auto &entry : index->nodes)
+                        m.label_index += block(index_node) + heap(heapUsage(entry.first)) + heap(heapUsage(entry.second));
+                }
+                m.contents       += heap(heapUsage(node->contents));
+
+                if(node->labeled)
+                    m.labels += heap(heapUsage(node->label));
+                for(const auto &entry : node->children)
+                    m.labels += heap(heapUsage(entry.first));
+            });
+
+            return m;
+        }
+
+        /**
+         * @brief memoryUsage
+         * @param allocator_overhead true to round every heap block up to the chunk size of the system allocator
+         * @return Total bytes used by this node and its descendants, see memoryBreakdown()
+         */
+        std::size_t memoryUsage(bool allocator_overhead = false) const { return memoryBreakdown(allocator_overhead).total(); }
+
+        /**
+         * @brief setChildIndexing Enables or disables the contiguous array of children kept by this node
+         * While enabled child() and childCount() are O(1) and children can be iterated with random access. Every child
+         * keeps its position in the array, so destroying one is O(1) and the next indexed access closes the gaps.
+         * @param enable
+         */
+        void setChildIndexing(bool enable)
+        {
+            if(enable)
+            {
+                if(!extras)
+                    extras = new Extras();
+
+                extras->child_array_enabled = true;
+                extras->child_array.clear();
+                extras->child_holes = 0;
+                for(Tree<T, U, A> &c : *this)
+                    indexChild(&c);
+            }
+            else if(extras)
+            {
+                extras->child_array_enabled = false;
+                extras->child_holes = 0;
+                std::vector<Tree<T, U, A>*>().swap(extras->child_array);
+                for(Tree<T, U, A> &c : *this)
+                    c.trimExtras();
+                trimExtras();
+            }
+        }
+
+        /**
+         * @brief getChildIndexing
+         * @return true if this node keeps a contiguous array of its children
+         */
+        bool getChildIndexing() const { return extras && extras->child_array_enabled; }
+
+        /**
+         * @brief setLabelIndexing Enables or disables the index from labels to the labeled nodes of the whole tree
+         * The index is kept up to date as nodes are added, moved and destroyed; query() uses it to start from the nodes
+         * carrying a label of the pattern instead of walking the tree.
+         * @param enable
+         */
+        void setLabelIndexing(bool enable)
+        {
+            if(parent)
+                throw "Tree label indexing can only be set on the root";
+
+            if(enable == getLabelIndexing())
+                return;
+
+            LabelIndex *index = enable ? new LabelIndex{ this, { } } : labelIndex();
+            walkSubtree([&](const Tree<T, U, A> *n, std::size_t) {
+                const_cast<Tree<T, U, A>*>(n)->joinTree(enable ? index : nullptr, n->treeWatch());
+            });
+
+            if(!enable)
+                delete index;
+        }
+
+        /**
+         * @brief getLabelIndexing
+         * @return true if this node belongs to a tree with a label index
+         */
+        bool getLabelIndexing() const { return labelIndex(); }
+
+        /**
+         * @brief labeledNodes All nodes of the tree labeled label, requires label indexing
+         * @param label
+         * @return The nodes in no particular order
+         */
+        std::vector<Tree<T, U, A>*> labeledNodes(const U &label) const
+        {
+            if(!getLabelIndexing())
+                throw "Tree label indexing is disabled";
+
+            auto it = labelIndex()->nodes.find(label);
+            return it == labelIndex()->nodes.end() ? std::vector<Tree<T, U, A>*>() : it->second;
+        }
+
+        /**
+         * @brief query Finds the nodes below this one whose path of labels matches pattern, see LabelPattern
+         * Only labeled children are followed and an empty pattern matches this node. With label indexing, patterns
+         * containing "**" start from the indexed nodes carrying the rarest literal label after the first "**" and
+         * only check the path around them. Other queries walk the matching part of the subtree.
+         * @param pattern
+         * @return Every matching node once, in no particular order
+         */
+        template <typename V = U>
+        std::vector<Tree<T, U, A>*> query(std::string_view pattern) const
+        {
+            static_assert(std::is_convertible<const V&, std::string_view>::value && std::is_constructible<V, std::string>::value,
+                          "Tree::query needs string labels");
+
+            LabelPattern p(pattern);
+            std::vector<Tree<T, U, A>*> result;
+
+            // segments before the first "**" are cheap to follow down, the index pays off for the literals after it
+            std::size_t rarest = p.size();
+            if(getLabelIndexing() && p.recursiveCount())
+            {
+                std::size_t fewest = 0;
+                std::size_t i = 0;
+                while(p[i].kind != LabelPattern::RECURSIVE)
+                    i++;
+
+                for(; i < p.size(); i++)
+                {
+                    if(p[i].kind != LabelPattern::LITERAL)
+                        continue;
+
+                    auto it = labelIndex()->nodes.find(U(p[i].text));
+                    std::size_t count = it == labelIndex()->nodes.end() ? 0 : it->second.size();
+                    if(rarest == p.size() || count < fewest)
+                    {
+                        rarest = i;
+                        fewest = count;
+                    }
+                }
+            }
+
+            if(rarest < p.size())
+                queryIndexed(p, rarest, result);
+            else
+                queryDown(p, const_cast<Tree<T, U, A>*>(this), 0, result);
+
+            // several "**", or one with several starting nodes, can reach a node twice
+            if(p.recursiveCount() > 1 || (p.recursiveCount() && rarest < p.size()))
+            {
+                std::unordered_set<Tree<T, U, A>*> seen;
+                result.erase(std::remove_if(result.begin(), result.end(), [&](Tree<T, U, A> *n) { return !seen.insert(n).second; }), result.end());
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief child Access child by position
+         * @param idx Position of the child among its siblings
+         * @return The child or nullptr if there are not enough children
+         */
+        Tree<T, U, A> *child(std::size_t idx) const
+        {
+            if(getChildIndexing())
+                return idx < childArray().size() ? childArray()[idx] : nullptr;
+
+            Tree<T, U, A> *c = first_child;
+            while(c && idx--)
+                c = c->right_node;
+            return c;
+        }
+
+        /**
+         * @brief childCount
+         * @return Number of children
+         */
+        std::size_t childCount() const
+        {
+            if(getChildIndexing())
+                return childArray().size();
+
+            std::size_t count = 0;
+            for(Tree<T, U, A> *c = first_child; c; c = c->right_node)
+                count++;
+            return count;
+        }
+
+        /**
+         * @brief ChildIterator Random access iterator over the children of a node with child indexing
+         * Yields const nodes, so algorithms cannot swap nodes behind the labels and links of the tree. Use reorderChildren() to reorder.
+         */
+        class ChildIterator
+        {
+            typename std::vector<Tree<T, U, A>*>::const_iterator it;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = Tree<T, U, A>;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const Tree<T, U, A>*;
+            using reference         = const Tree<T, U, A>&;
+
+            ChildIterator() = default;
+            ChildIterator(typename std::vector<Tree<T, U, A>*>::const_iterator it) : it(it) { }
+
+            ChildIterator &operator ++() { ++it; return *this; }
+            ChildIterator &operator --() { --it; return *this; }
+
+            ChildIterator operator ++(int) { ChildIterator copy(*this); ++it; return copy; }
+            ChildIterator operator --(int) { ChildIterator copy(*this); --it; return copy; }
+
+            ChildIterator &operator +=(difference_type add) { it += add; return *this; }
+            ChildIterator &operator -=(difference_type sub) { it -= sub; return *this; }
+
+            ChildIterator operator +(difference_type add) const { return ChildIterator(it + add); }
+            ChildIterator operator -(difference_type sub) const { return ChildIterator(it - sub); }
+            friend ChildIterator operator +(difference_type add, const ChildIterator &i) { return i + add; }
+
+            difference_type operator -(const ChildIterator &other) const { return it - other.it; }
+
+            bool operator ==(const ChildIterator &other) const { return it == other.it; }
+            bool operator !=(const ChildIterator &other) const { return it != other.it; }
+            bool operator  <(const ChildIterator &other) const { return it <  other.it; }
+            bool operator  >(const ChildIterator &other) const { return it >  other.it; }
+            bool operator <=(const ChildIterator &other) const { return it <= other.it; }
+            bool operator >=(const ChildIterator &other) const { return it >= other.it; }
+
+            const Tree<T, U, A> &operator[](difference_type idx) const { return *it[idx]; }
+            const Tree<T, U, A> &operator *()  const { return **it; }
+            const Tree<T, U, A> *operator ->() const { return *it; }
+        };
+
+        /**
+         * @brief childrenBegin Random access iterator over the children, requires child indexing
+         * @return
+         */
+        ChildIterator childrenBegin() const { return ChildIterator(childArray().begin()); }
+        ChildIterator childrenEnd()   const { return ChildIterator(childArray().end()); }
+
+        /**
+         * @brief reorderChildren Lets f permute the child array and relinks the siblings to match, requires child indexing
+         * @param f Called with random access iterators to the begin and end of the child pointers, e.g. to std::sort or std::nth_element them
+         */
+        template <typename F>
+        void reorderChildren(F f)
+        {
+            if(!getChildIndexing())
+                throw "Tree child indexing is disabled";
+
+            compactChildren();
+            std::vector<Tree<T, U, A>*> &child_array = extras->child_array;
+            f(child_array.begin(), child_array.end());
+            invalidate();
+            structureChanged();
+
+            first_child = last_child = nullptr;
+            for(std::size_t i = 0; i < child_array.size(); i++)
+            {
+                Tree<T, U, A> *c = child_array[i];
+                c->extras->child_slot = i;
+                c->left_node = last_child;
+                c->right_node = nullptr;
+
+                if(last_child) last_child->right_node = c;
+                else           first_child = c;
+
+                last_child = c;
+            }
+        }
+
+        /**
+         * @brief clear Deletes all descendants without recursion, so deep trees do not exhaust the call stack
          */
         void clear()
         {
-            std::vector<Tree<T, U>*> del_ptrs;
+            std::vector<Tree<T, U, A>*> pending;
+            unlinkChildren(pending);
+            if(pending.empty())
+                return;
 
-            for(Tree<T, U> &a : *this)
-                del_ptrs.push_back(&a);
+            invalidate();
+            structureChanged();
 
-            for(Tree<T, U>* ptr : del_ptrs)
-                delete ptr;
+            // every node is cut from its children before it is deleted, so its destructor has nothing to recurse into
+            while(pending.size())
+            {
+                Tree<T, U, A> *node = pending.back();
+                pending.pop_back();
 
-            first_child = nullptr;
-            last_child  = nullptr;
+                node->unlinkChildren(pending);
+                delete node;
+            }
         }
     };
 }
@@ -0,0 +1,176 @@
+#ifndef TREEBUILDER_H
+#define TREEBUILDER_H
+
+#include "stack.h"
+#include "tree.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace Types
+{
+    /**
+     * @brief TreeBuilder Event driven, non-recursive construction of a Tree in document order
+     * Only the path from the root to the current node is kept, so memory besides the tree itself is bounded by its depth.
+     */
+    template <typename T, typename U = std::string>
+    class TreeBuilder
+    {
+        Stack<Tree<T, U>*> path;
+
+    public:
+        /**
+         * @brief TreeBuilder
+         * @param root Node the built nodes are appended to, it is the current node until the first enter()
+         */
+        TreeBuilder(Tree<T, U> &root) { path.push_top(&root); }
+
+        /**
+         * @brief enter Appends a labeled child to the current node and makes it the current node
+         * Throws if the current node already has a child with the same label, instead of clearing what was built under it.
+         * @param label
+         * @return The new current node
+         */
+        Tree<T, U> *enter(const U &label)
+        {
+            if(current()[label])
+                throw "TreeBuilder entered a duplicate label";
+
+            Tree<T, U> *child = current().emplaceLabeledChild(label);
+            path.push_top(child);
+            return child;
+        }
+
+        /**
+         * @brief enter Appends an unlabeled child to the current node and makes it the current node
+         * @return The new current node
+         */
+        Tree<T, U> *enter()
+        {
+            Tree<T, U> *child = current().emplaceChild();
+            path.push_top(child);
+            return child;
+        }
+
+        /**
+         * @brief value Sets the contents of the current node
+         * @param t
+         */
+        void value(const T &t) { current().getContents() = t; }
+        void value(T &&t)      { current().getContents() = std::move(t); }
+
+        /**
+         * @brief leave Makes the parent of the current node the current node
+         */
+        void leave()
+        {
+            if(path.size() <= 1)
+                throw "TreeBuilder left the root";
+
+            path.pop_top();
+        }
+
+        /**
+         * @brief current
+         * @return The node values are currently written to
+         */
+        Tree<T, U> &current() const { return *path[0]; }
+
+        /**
+         * @brief depth
+         * @return Number of enter() calls not matched by leave() yet
+         */
+        std::size_t depth() const { return path.size() - 1; }
+    };
+
+    /**
+     * @brief IndentedTreeReader Feeds indented text to a TreeBuilder in chunks of any size
+     * Every non-blank line is a node: "label" or "label: value", nested under the closest preceding line with less
+     * indentation. Values are converted with parse, a callable taking a std::string_view and returning T. A label repeated
+     * among siblings throws, see TreeBuilder::enter().
+     * Only an unfinished line and the indentation of the current path are kept between chunks.
+     */
+    template <typename T, typename Parse>
+    class IndentedTreeReader
+    {
+        TreeBuilder<T, std::string> &builder;
+        Parse parse;
+
+        std::string pending;
+        Stack<std::size_t> indents;
+
+        static std::string_view trim(std::string_view s)
+        {
+            while(!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while(!s.empty() && (s.back()  == ' ' || s.back()  == '\t' || s.back() == '\r')) s.remove_suffix(1);
+            return s;
+        }
+
+        void line(std::string_view l)
+        {
+            std::size_t indent = l.find_first_not_of(" \t");
+            if(indent == std::string_view::npos || trim(l).empty())
+                return;
+
+            while(indents.size() && *indents.begin() >= indent)
+            {
+                builder.leave();
+                indents.pop_top();
+            }
+
+            l = trim(l);
+            std::size_t colon = l.find(':');
+
+            builder.enter(std::string(trim(l.substr(0, colon))));
+            indents.push_top(indent);
+
+            if(colon != std::string_view::npos)
+                builder.value(parse(trim(l.substr(colon + 1))));
+        }
+
+    public:
+        IndentedTreeReader(TreeBuilder<T, std::string> &builder, Parse parse) : builder(builder), parse(std::move(parse)) { }
+
+        /**
+         * @brief feed Processes the complete lines in chunk, a trailing partial line waits for the next chunk
+         * @param chunk
+         */
+        void feed(std::string_view chunk)
+        {
+            std::size_t nl;
+            while((nl = chunk.find('\n')) != std::string_view::npos)
+            {
+                if(pending.empty())
+                    line(chunk.substr(0, nl));
+                else
+                {
+                    pending.append(chunk.data(), nl);
+                    line(pending);
+                    pending.clear();
+                }
+                chunk.remove_prefix(nl + 1);
+            }
+
+            pending.append(chunk.data(), chunk.size());
+        }
+
+        /**
+         * @brief finish Processes a last line without newline and leaves all nodes entered by this reader
+         */
+        void finish()
+        {
+            line(pending);
+            pending.clear();
+
+            while(indents.size())
+            {
+                builder.leave();
+                indents.pop_top();
+            }
+        }
+    };
+}
+
+#endif // TREEBUILDER_H
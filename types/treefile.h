@@ -0,0 +1,410 @@
+#ifndef TREEFILE_H
+#define TREEFILE_H
+
+#include "tree.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Types
+{
+    /**
+     * @brief TreeFile Read-only memory mapped view of a Tree<T, std::string> saved with TreeFile<T>::save()
+     * Nodes are stored breadth first, so the children of a node are consecutive records. Links are node numbers
+     * instead of pointers, labels live in a string table and every node has a slice of a label sorted children index.
+     * Opening a file maps it without reading it; pages are only loaded when the nodes on them are accessed.
+     * The format uses the byte order and layout of T of the machine that wrote it.
+     */
+    template <typename T>
+    class TreeFile
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "TreeFile requires trivially copyable contents");
+
+        static constexpr char magic[8] = { 'A', 'U', 'T', 'T', 'R', 'E', 'E', '1' };
+        static constexpr std::uint64_t none = ~std::uint64_t(0);
+
+        struct Header
+        {
+            char magic[8];
+            std::uint64_t contents_size;
+            std::uint64_t node_count;
+            std::uint64_t nodes_offset;
+            std::uint64_t contents_offset;
+            std::uint64_t index_offset;
+            std::uint64_t index_count;
+            std::uint64_t strings_offset;
+            std::uint64_t strings_size;
+        };
+
+        struct Record
+        {
+            std::uint64_t parent;
+            std::uint64_t first_child;
+            std::uint64_t child_count;
+            std::uint64_t index_begin;   // labeled children in the children index, sorted by label
+            std::uint64_t index_count;
+            std::uint64_t label_offset;
+            std::uint32_t label_size;
+            std::uint32_t labeled;
+        };
+
+        const char *map = nullptr;
+        std::size_t map_size = 0;
+
+        const Header *header = nullptr;
+        const Record *records = nullptr;
+        const T *contents = nullptr;
+        const std::uint64_t *index = nullptr;
+        const char *strings = nullptr;
+
+        static std::uint64_t align(std::uint64_t offset, std::uint64_t alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+        static void writeAll(int fd, const void *data, std::size_t size)
+        {
+            const char *p = static_cast<const char*>(data);
+            while(size)
+            {
+                ssize_t w = ::write(fd, p, size);
+                if(w < 0)
+                    throw "TreeFile write failed";
+                p += w;
+                size -= static_cast<std::size_t>(w);
+            }
+        }
+
+        static void writePadding(int fd, std::uint64_t &offset, std::uint64_t target)
+        {
+            static const char zeros[64] = { };
+            while(offset < target)
+            {
+                std::size_t n = std::min<std::uint64_t>(target - offset, sizeof(zeros));
+                writeAll(fd, zeros, n);
+                offset += n;
+            }
+        }
+
+        /**
+         * @brief inside Checks without overflowing that count elements of size bytes at offset lie inside the mapping
+         */
+        bool inside(std::uint64_t offset, std::uint64_t count, std::size_t size, std::size_t alignment) const
+        {
+            return offset % alignment == 0 && offset <= map_size && count <= (map_size - offset) / size;
+        }
+
+        /**
+         * @brief record Checks the links and slices of a record against the header when it is first read through
+         * The file is only trusted as far as the header, which open checks, so a corrupt record throws instead of reading outside the mapping.
+         * @param node
+         * @return
+         */
+        const Record &record(std::uint64_t node) const
+        {
+            if(node >= header->node_count)
+                throw "TreeFile record is corrupt";
+
+            const Record &r = records[node];
+            if((r.parent == none ? node != 0 : r.parent >= node) ||
+               r.first_child > header->node_count || r.child_count > header->node_count - r.first_child ||
+               r.index_begin > header->index_count || r.index_count > header->index_count - r.index_begin ||
+               r.label_offset > header->strings_size || r.label_size > header->strings_size - r.label_offset)
+                throw "TreeFile record is corrupt";
+
+            return r;
+        }
+
+        std::string_view labelOf(std::uint64_t node) const { const Record &r = record(node); return std::string_view(strings + r.label_offset, r.label_size); }
+
+    public:
+        class Node;
+
+        class ChildIterator
+        {
+            const TreeFile<T> *file = nullptr;
+            std::uint64_t idx = 0;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = Node;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = Node;
+
+            ChildIterator() = default;
+            ChildIterator(const TreeFile<T> *file, std::uint64_t idx) : file(file), idx(idx) { }
+
+            ChildIterator &operator ++() { idx++; return *this; }
+            ChildIterator &operator --() { idx--; return *this; }
+
+            ChildIterator operator ++(int) { ChildIterator copy(*this); idx++; return copy; }
+            ChildIterator operator --(int) { ChildIterator copy(*this); idx--; return copy; }
+
+            ChildIterator &operator +=(difference_type add) { idx += add; return *this; }
+            ChildIterator &operator -=(difference_type sub) { idx -= sub; return *this; }
+
+            ChildIterator operator +(difference_type add) const { return ChildIterator(file, idx + add); }
+            ChildIterator operator -(difference_type sub) const { return ChildIterator(file, idx - sub); }
+
+            difference_type operator -(const ChildIterator &other) const { return difference_type(idx - other.idx); }
+
+            bool operator ==(const ChildIterator &other) const { return idx == other.idx; }
+            bool operator !=(const ChildIterator &other) const { return idx != other.idx; }
+            bool operator  <(const ChildIterator &other) const { return idx <  other.idx; }
+
+            Node operator[](difference_type i) const { return Node(file, idx + i); }
+            Node operator *() const { return Node(file, idx); }
+        };
+
+        /**
+         * @brief Node Handle to a node of a TreeFile, cheap to copy
+         */
+        class Node
+        {
+            const TreeFile<T> *file = nullptr;
+            std::uint64_t idx = none;
+
+            const Record &record() const { return file->record(idx); }
+
+        public:
+            Node() = default;
+            Node(const TreeFile<T> *file, std::uint64_t idx) : file(file), idx(idx) { }
+
+            /**
+             * @brief valid
+             * @return false for the handle returned for missing nodes
+             */
+            bool valid() const { return idx != none; }
+            explicit operator bool() const { return valid(); }
+
+            bool operator ==(const Node &other) const { return file == other.file && idx == other.idx; }
+            bool operator !=(const Node &other) const { return !(*this == other); }
+
+            const T &getContents() const { return file->contents[idx]; }
+            const T &operator*()   const { return getContents(); }
+
+            std::string_view getLabel() const { return file->labelOf(idx); }
+            bool isLabeled() const { return record().labeled; }
+
+            Node getParent() const { return Node(file, record().parent); }
+
+            std::size_t childCount() const { return record().child_count; }
+
+            /**
+             * @brief child Access child by position
+             * @param k
+             * @return The child or an invalid handle
+             */
+            Node child(std::size_t k) const { return k < record().child_count ? Node(file, record().first_child + k) : Node(); }
+
+            /**
+             * @brief operator [] Access labeled child by binary search in the children index
+             * @param label
+             * @return The child or an invalid handle
+             */
+            Node operator[](std::string_view label) const
+            {
+                const std::uint64_t *lo = file->index + record().index_begin;
+                const std::uint64_t *hi = lo + record().index_count;
+
+                while(lo < hi)
+                {
+                    const std::uint64_t *mid = lo + (hi - lo) / 2;
+                    if(file->labelOf(*mid) < label) lo = mid + 1;
+                    else                            hi = mid;
+                }
+
+                if(lo != file->index + record().index_begin + record().index_count && file->labelOf(*lo) == label)
+                    return Node(file, *lo);
+
+                return Node();
+            }
+
+            ChildIterator begin() const { return ChildIterator(file, record().first_child); }
+            ChildIterator end()   const { return ChildIterator(file, record().first_child + record().child_count); }
+        };
+
+        /**
+         * @brief save Writes tree in the TreeFile format to fd starting at its current position
+         * @param tree
+         * @param fd
+         */
+        static void save(const Tree<T, std::string> &tree, int fd)
+        {
+            std::vector<const Tree<T, std::string>*> order = { &tree };
+            std::vector<Record> recs;
+            std::vector<std::uint64_t> idx;
+            std::string strs;
+            std::unordered_map<std::string, std::uint64_t> string_offsets;
+
+            recs.push_back(Record{none, 0, 0, 0, 0, 0, 0, 0});
+
+            for(std::size_t i = 0; i < order.size(); i++)
+            {
+                const Tree<T, std::string> &node = *order[i];
+
+                if(node.isLabeled())
+                {
+                    const std::string &label = node.getLabel();
+                    if(label.size() > UINT32_MAX)
+                        throw "TreeFile label is too long";
+
+                    auto it = string_offsets.find(label);
+                    if(it == string_offsets.end())
+                    {
+                        it = string_offsets.emplace(label, strs.size()).first;
+                        strs += label;
+                    }
+                    recs[i].label_offset = it->second;
+                    recs[i].label_size = static_cast<std::uint32_t>(label.size());
+                    recs[i].labeled = 1;
+                }
+
+                recs[i].first_child = order.size();
+                recs[i].index_begin = idx.size();
+
+                for(Tree<T, std::string> &c : node)
+                {
+                    if(c.isLabeled())
+                        idx.push_back(order.size());
+
+                    order.push_back(&c);
+                    recs.push_back(Record{i, 0, 0, 0, 0, 0, 0, 0});
+                }
+
+                recs[i].child_count = order.size() - recs[i].first_child;
+                recs[i].index_count = idx.size() - recs[i].index_begin;
+
+                std::sort(idx.begin() + recs[i].index_begin, idx.end(), [&](std::uint64_t a, std::uint64_t b) {
+                    return order[a]->getLabel() < order[b]->getLabel();
+                });
+            }
+
+            Header h;
+            std::memcpy(h.magic, magic, sizeof(magic));
+            h.contents_size   = sizeof(T);
+            h.node_count      = order.size();
+            h.nodes_offset    = align(sizeof(Header), alignof(Record));
+            h.contents_offset = align(h.nodes_offset + recs.size() * sizeof(Record), std::max(alignof(T), alignof(std::uint64_t)));
+            h.index_offset    = align(h.contents_offset + order.size() * sizeof(T), alignof(std::uint64_t));
+            h.index_count     = idx.size();
+            h.strings_offset  = h.index_offset + idx.size() * sizeof(std::uint64_t);
+            h.strings_size    = strs.size();
+
+            std::uint64_t offset = 0;
+            writeAll(fd, &h, sizeof(h));
+            offset += sizeof(h);
+
+            writePadding(fd, offset, h.nodes_offset);
+            writeAll(fd, recs.data(), recs.size() * sizeof(Record));
+            offset += recs.size() * sizeof(Record);
+
+            std::vector<T> staged;
+            staged.reserve(order.size());
+            for(const Tree<T, std::string> *n : order)
+                staged.push_back(n->getContents());
+
+            writePadding(fd, offset, h.contents_offset);
+            writeAll(fd, staged.data(), staged.size() * sizeof(T));
+            offset += staged.size() * sizeof(T);
+
+            writePadding(fd, offset, h.index_offset);
+            writeAll(fd, idx.data(), idx.size() * sizeof(std::uint64_t));
+            writeAll(fd, strs.data(), strs.size());
+        }
+
+        /**
+         * @brief save Writes tree in the TreeFile format to the file at path
+         * @param tree
+         * @param path
+         */
+        static void save(const Tree<T, std::string> &tree, const std::string &path)
+        {
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if(fd < 0)
+                throw "TreeFile could not be created";
+
+            try { save(tree, fd); }
+            catch(...) { ::close(fd); throw; }
+
+            ::close(fd);
+        }
+
+        /**
+         * @brief TreeFile Maps the file at path read-only
+         * @param path
+         */
+        TreeFile(const std::string &path)
+        {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if(fd < 0)
+                throw "TreeFile could not be opened";
+
+            struct stat st;
+            if(::fstat(fd, &st) < 0 || std::size_t(st.st_size) < sizeof(Header))
+            {
+                ::close(fd);
+                throw "TreeFile is too short";
+            }
+
+            map_size = std::size_t(st.st_size);
+            void *m = ::mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+
+            if(m == MAP_FAILED)
+                throw "TreeFile could not be mapped";
+
+            map = static_cast<const char*>(m);
+            header = reinterpret_cast<const Header*>(map);
+
+            if(std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->contents_size != sizeof(T) || header->node_count == 0 ||
+               !inside(header->nodes_offset, header->node_count, sizeof(Record), alignof(Record)) ||
+               !inside(header->contents_offset, header->node_count, sizeof(T), alignof(T)) ||
+               !inside(header->index_offset, header->index_count, sizeof(std::uint64_t), alignof(std::uint64_t)) ||
+               !inside(header->strings_offset, header->strings_size, 1, 1))
+            {
+                ::munmap(m, map_size);
+                throw "TreeFile has an invalid header";
+            }
+
+            records  = reinterpret_cast<const Record*>(map + header->nodes_offset);
+            contents = reinterpret_cast<const T*>(map + header->contents_offset);
+            index    = reinterpret_cast<const std::uint64_t*>(map + header->index_offset);
+            strings  = map + header->strings_offset;
+        }
+
+        TreeFile(const TreeFile<T> &) = delete;
+        TreeFile<T> &operator=(const TreeFile<T> &) = delete;
+
+        ~TreeFile()
+        {
+            if(map)
+                ::munmap(const_cast<char*>(map), map_size);
+        }
+
+        /**
+         * @brief root
+         * @return Handle to the root node, valid while the TreeFile exists
+         */
+        Node root() const { return Node(this, 0); }
+
+        /**
+         * @brief size
+         * @return Number of nodes in the file
+         */
+        std::size_t size() const { return header->node_count; }
+    };
+}
+
+#endif // TREEFILE_H